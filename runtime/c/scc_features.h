@@ -0,0 +1,97 @@
+/* Reports coverage features to SCC via the shared memory feature map.
+ *
+ * SCC passes the name and size of the map via the SCC_FEATURE_MAP and
+ * SCC_FEATURE_MAP_SIZE environment variables to the oracle. Every process
+ * started by the oracle inherits them, so this header can be included in
+ * the oracle itself or in the compiler that is being tested.
+ *
+ * Manual instrumentation:
+ *
+ *   scc_feature_hit(42);
+ *
+ * Compilers built with -fsanitize-coverage=trace-pc-guard only need one
+ * translation unit with:
+ *
+ *   #define SCC_FEATURES_SANITIZER_COVERAGE
+ *   #include "scc_features.h"
+ *
+ * Without SCC (or without --feature-map-size=) all functions do nothing.
+ */
+#ifndef SCC_FEATURES_H
+#define SCC_FEATURES_H
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static uint8_t *scc_feature_map = 0;
+static size_t scc_feature_map_size = 0;
+static int scc_feature_map_initialized = 0;
+
+/* Maps the feature map of SCC. Called automatically on the first hit. */
+static void scc_features_init(void) {
+  const char *name;
+  const char *size_str;
+  size_t size;
+  int fd;
+  void *mem;
+
+  scc_feature_map_initialized = 1;
+  name = getenv("SCC_FEATURE_MAP");
+  size_str = getenv("SCC_FEATURE_MAP_SIZE");
+  if (!name || !size_str)
+    return;
+  size = strtoul(size_str, 0, 10);
+  if (size == 0)
+    return;
+  fd = shm_open(name, O_RDWR, 0);
+  if (fd < 0)
+    return;
+  mem = mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mem == MAP_FAILED)
+    return;
+  scc_feature_map = (uint8_t *)mem;
+  scc_feature_map_size = size;
+}
+
+/* Records that the feature with the given id was hit. Ids larger than the
+ * map wrap around. Counters saturate at 255. */
+static inline void scc_feature_hit(uint32_t id) {
+  uint8_t *counter;
+  if (!scc_feature_map_initialized)
+    scc_features_init();
+  if (!scc_feature_map)
+    return;
+  counter = &scc_feature_map[id % scc_feature_map_size];
+  if (*counter != 255)
+    ++*counter;
+}
+
+#ifdef SCC_FEATURES_SANITIZER_COVERAGE
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void __sanitizer_cov_trace_pc_guard_init(uint32_t *start, uint32_t *stop) {
+  static uint32_t next_id = 1;
+  uint32_t *guard;
+  if (start == stop || *start)
+    return;
+  for (guard = start; guard < stop; ++guard)
+    *guard = next_id++;
+}
+
+void __sanitizer_cov_trace_pc_guard(uint32_t *guard) {
+  if (*guard)
+    scc_feature_hit(*guard);
+}
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* SCC_FEATURES_SANITIZER_COVERAGE */
+
+#endif /* SCC_FEATURES_H */
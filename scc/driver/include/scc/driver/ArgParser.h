@@ -1,6 +1,9 @@
 #ifndef ARGPARSER_H
 #define ARGPARSER_H
 
+#include "scc/mutator-utils/IslandScheduler.h"
+#include "scc/mutator-utils/PowerSchedule.h"
+
 #include <limits>
 #include <optional>
 #include <set>
@@ -51,7 +54,89 @@ public:
   // some basic setup is messed up and causes FPs.
   std::size_t stopAfterHits = 100000;
   unsigned reducerTries = 3000;
+  /// How many reduction candidates are evaluated in parallel.
+  unsigned reducerThreads = 1;
+  /// How many mutants are created ahead of time while the oracle runs
+  /// (0 = mutate before each oracle run).
+  size_t pipelineDepth = 0;
+  /// How many findings are reduced in the background (0 = pause fuzzing
+  /// while reducing).
+  size_t backgroundReductions = 0;
+  /// Percentage of time each background reduction may use.
+  unsigned reductionCPUShare = 100;
+  /// Percentage of candidates the surrogate model skips (0 = disabled).
+  unsigned surrogateSkip = 0;
+  /// Percentage of low value candidates that are evaluated anyway.
+  unsigned surrogateExploration = 10;
+  /// How many better queue entries an entry may be similar to (0 = no
+  /// limit).
+  size_t maxSimilar = 0;
+  /// From which percentage of shared structure two entries are similar.
+  unsigned similarity = 90;
+  /// How many findings with the same bug signature are reduced.
+  size_t reductionsPerSignature = 1;
+  /// How many constants suggested via FUZZ:DICT are remembered.
+  size_t dictionarySize = 256;
+  /// Limits for mutated programs that are checked before running the oracle
+  /// (0 = unlimited).
+  size_t maxNodes = 0;
+  size_t maxBytes = 0;
+  size_t maxDepth = 0;
+  /// Shell commands of the cheap oracles that run before the main oracle.
+  std::vector<std::string> preOracles;
+  /// Number of coverage counters shared with the oracle (0 = disabled).
+  size_t featureMapSize = 0;
   size_t seed = 0;
+  /// Evolve the mutation strategies every N iterations (0 = never).
+  size_t evolveEvery = 0;
+  size_t maxStrategies = 32;
+  std::string strategyFile;
+  /// File that oracle results are persisted in (empty = disabled).
+  std::string resultStore;
+  size_t resultStoreMaxMB = 1024;
+  /// Directory that checkpoints are written to (empty = disabled).
+  std::string checkpointDir;
+  /// Write a checkpoint every N iterations.
+  size_t checkpointEvery = 10000;
+  /// Checkpoint directory to resume from (empty = start from scratch).
+  std::string resumeDir;
+  /// Directory with saved '.scc' programs to start from (empty = generate).
+  std::string seedCorpus;
+  /// The maximum number of programs loaded from the seed corpus.
+  size_t seedCorpusMax = 100;
+  /// Directory shared with other instances (empty = no syncing).
+  std::string syncDir;
+  /// The name of this instance in the sync directory.
+  std::string syncName;
+  /// Whether this instance imports from all instances or only the primary.
+  bool syncPrimary = false;
+  /// Sync with other instances every N iterations.
+  size_t syncEvery = 5000;
+  /// The maximum number of programs imported per sync.
+  size_t syncImportBudget = 20;
+  /// Address to hand out mutations to cluster workers on (empty = none).
+  std::string clusterCoordinator;
+  /// Address of the coordinator to run mutations for (empty = none).
+  std::string clusterWorker;
+  /// How many jobs a cluster worker requests at once.
+  size_t clusterBatch = 4;
+  /// After how many seconds the coordinator drops an unfinished job (0 =
+  /// only when the worker disconnects).
+  size_t clusterJobTimeout = 600;
+  /// How many schedulers run in parallel on their own threads.
+  size_t islands = 1;
+  /// Islands send migrants to another island every N iterations.
+  size_t migrateEvery = 5000;
+  /// How many of its best programs an island sends per migration.
+  size_t migrants = 2;
+  MigrationTopology migrationTopology = MigrationTopology::Ring;
+  float decisionLearningRate = 0.02f;
+  PowerSchedule powerSchedule = PowerSchedule::Fixed;
+  /// Store queue entries as replayable mutations instead of full programs.
+  bool compactQueue = false;
+  size_t materializedPrograms = 16;
+  /// Schedule crossover between queue entries like a mutation strategy.
+  bool crossover = false;
 
   std::vector<std::string> unknownArgs;
 };
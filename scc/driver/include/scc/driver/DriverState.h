@@ -1,19 +1,34 @@
 #ifndef DRIVER_STATE_H
 #define DRIVER_STATE_H
 
+#include "scc/driver/OracleStage.h"
+#include "scc/mutator-utils/IslandScheduler.h"
 #include "scc/mutator-utils/Scheduler.h"
 #include "scc/program/Program.h"
 
+#include <atomic>
+#include <mutex>
+
 /// The fuzzer state that the different views see.
+///
+/// Programs can be evaluated from several threads at once, so everything the
+/// evaluation writes is either atomic or guarded by a mutex.
 struct DriverState {
   DriverState(SchedulerBase &scheduler, std::string evalCommand,
               std::string saveDir);
 
   SchedulerBase &scheduler;
-  Program lastProg;
 
   /// The command that should be run on each program.
   std::string evalCommand;
+  /// Cheaper oracles that run before `evalCommand` in the given order.
+  std::vector<std::unique_ptr<OracleStage>> preOracles;
+  /// The number of coverage counters shared with the oracle (0 if the oracle
+  /// doesn't report coverage).
+  size_t featureMapSize = 0;
+  /// The parallel schedulers whose first island is `scheduler` (null if
+  /// only one scheduler runs).
+  const IslandSchedulerBase *islands = nullptr;
   /// The directory path to save interesting cases to.
   std::string saveDir;
 
@@ -28,9 +43,9 @@ struct DriverState {
   std::string uniqueFileID;
 
   /// How much time we spent in the oracle so far.
-  size_t millisExe = 0;
+  std::atomic<size_t> millisExe = 0;
   /// How many programs we actually executed (doesn't count cache hits).
-  size_t execs = 0;
+  std::atomic<size_t> execs = 0;
 
   typedef std::function<std::string(const Program &p)> Annotation;
   /// Function that can prepend some code to the final program.
@@ -61,20 +76,43 @@ struct DriverState {
   /// Try to print the given program to the given output path.
   OptError printProg(const Program &p, std::string outPath);
 
-  /// Save a program to the output folder.
+  /// Save a program to the output folder. Next to the source file, the
+  /// program is also stored as a '.scc' file that ProgramSerializer can load.
   void saveProg(const Program &p, std::string prefix);
 
   /// Add a message from the oracle to the internal storage.
   void addMessageWithTimestamp(std::string msg, std::string timestamp) {
+    std::lock_guard<std::mutex> lock(mutex);
     messages.push_back({timestamp, msg});
     while (messages.size() > maxStoredMessages)
       messages.pop_front();
   }
 
+  /// Add a message that is timestamped with the current time.
+  void addMessage(std::string msg);
+
   /// Returns the list of all messages received so far.
-  std::deque<Message> getMessages() const { return messages; }
+  std::deque<Message> getMessages() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return messages;
+  }
+
+  /// Sets the program that was evaluated last.
+  void setLastProg(const Program &p) {
+    std::lock_guard<std::mutex> lock(mutex);
+    lastProg = p;
+  }
+
+  /// Returns the program that was evaluated last.
+  Program getLastProg() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return lastProg;
+  }
 
 private:
+  /// Guards the last program and the messages.
+  mutable std::mutex mutex;
+  Program lastProg;
   /// Maximum number of messages that we should store before deleting old ones.
   std::size_t maxStoredMessages = 1000;
   /// List of stores messages from the oracle.
@@ -3,6 +3,7 @@
 
 #include <optional>
 #include <string>
+#include <vector>
 
 /// Utils for test oracle operations (parsing output, running it).
 class Executor {
@@ -10,6 +11,10 @@ public:
   static std::optional<std::string> getValue(std::string output,
                                              std::string key);
 
+  /// Returns the values of all lines starting with the given key.
+  static std::vector<std::string> getValues(const std::string &output,
+                                            const std::string &key);
+
   /// Whether the given output has a fuzzer message with the given key.
   /// e.g. 'FUZZ:MSG:'
   static bool hasValue(std::string output, std::string key);
@@ -0,0 +1,59 @@
+#ifndef ORACLESTAGE_H
+#define ORACLESTAGE_H
+
+#include "scc/mutator-utils/ProgramCache.h"
+
+#include <atomic>
+#include <string>
+
+/// A cheap oracle that runs before the main oracle (see `--pre-oracle=`).
+///
+/// A stage rejects a program by reporting a score or a dead end. Programs it
+/// doesn't reject are passed on to the next stage. Programs that already
+/// passed a stage are remembered, so the stage doesn't run on them again.
+/// All methods can be called concurrently from multiple threads.
+class OracleStage {
+public:
+  explicit OracleStage(std::string command) : command(command) {}
+
+  /// The shell command that is run with the path of the program appended.
+  const std::string &getCommand() const { return command; }
+
+  /// Returns true if the stage output rejects the program.
+  static bool isRejection(const std::string &output);
+
+  /// Returns true if the program with the given hash already passed this
+  /// stage.
+  bool passedBefore(HashStream::Hash hash) const {
+    return survivors.isInCacheNoInsert(hash);
+  }
+
+  /// Records a run of this stage on a program with the given hash.
+  ///
+  /// @param rejected True if the stage rejected the program.
+  void addRun(HashStream::Hash hash, size_t millis, bool rejected);
+
+  /// Records that the stage was skipped as the program passed it before.
+  void addCacheHit() { ++cacheHits; }
+
+  size_t getRuns() const { return runs; }
+  size_t getRejections() const { return rejections; }
+  size_t getCacheHits() const { return cacheHits; }
+  size_t getMillis() const { return millis; }
+
+  /// Returns a one-line summary of the stage statistics.
+  std::string getSummary() const;
+
+private:
+  std::string command;
+  /// The programs that passed this stage.
+  ProgramCache survivors;
+
+  std::atomic<size_t> runs = 0;
+  std::atomic<size_t> rejections = 0;
+  std::atomic<size_t> cacheHits = 0;
+  /// How much time was spent running this stage.
+  std::atomic<size_t> millis = 0;
+};
+
+#endif // ORACLESTAGE_H
@@ -0,0 +1,48 @@
+#ifndef SHAREDFEATUREMAP_H
+#define SHAREDFEATUREMAP_H
+
+#include "scc/utils/Maybe.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/// A map of coverage hit counters that an oracle can write to.
+///
+/// The map is a POSIX shared memory object. Its name and size are passed to
+/// the oracle via the `SCC_FEATURE_MAP` and `SCC_FEATURE_MAP_SIZE`
+/// environment variables (see `runtime/c/scc_features.h`).
+class SharedFeatureMap {
+public:
+  static constexpr const char *nameVar = "SCC_FEATURE_MAP";
+  static constexpr const char *sizeVar = "SCC_FEATURE_MAP_SIZE";
+
+  /// Creates a new shared memory map with the given number of counters.
+  static Maybe<std::unique_ptr<SharedFeatureMap>> create(size_t size);
+  ~SharedFeatureMap();
+
+  SharedFeatureMap(const SharedFeatureMap &) = delete;
+  SharedFeatureMap &operator=(const SharedFeatureMap &) = delete;
+
+  /// Resets all counters to 0.
+  void clear();
+
+  /// Returns the environment variable assignments that have to be prepended
+  /// to a shell command so that the oracle finds this map.
+  std::string getEnvPrefix() const;
+
+  const std::string &getName() const { return name; }
+  const uint8_t *data() const { return counters; }
+  size_t size() const { return mapSize; }
+
+private:
+  SharedFeatureMap(std::string name, uint8_t *counters, size_t size)
+      : name(name), counters(counters), mapSize(size) {}
+
+  std::string name;
+  uint8_t *counters = nullptr;
+  size_t mapSize = 0;
+};
+
+#endif // SHAREDFEATUREMAP_H
@@ -0,0 +1,19 @@
+#ifndef ISLAND_VIEW_H
+#define ISLAND_VIEW_H
+
+#include "scc/driver/views/View.h"
+
+/// Shows the progress and migrations of every island when several
+/// schedulers run in parallel.
+struct IslandView : View {
+  ~IslandView() override = default;
+
+  void draw(const DriverState &state) override;
+  void handleInput(const Input &input, DriverState &state) override;
+  std::string getName() const override { return "Islands"; }
+
+private:
+  unsigned startLine = 0;
+};
+
+#endif // ISLAND_VIEW_H
@@ -0,0 +1,18 @@
+#ifndef STRATEGY_VIEW_H
+#define STRATEGY_VIEW_H
+
+#include "scc/driver/views/View.h"
+
+/// Shows what each mutation strategy gained and what it cost so far.
+struct StrategyView : View {
+  ~StrategyView() override = default;
+
+  void draw(const DriverState &state) override;
+  void handleInput(const Input &input, DriverState &state) override;
+  std::string getName() const override { return "Strategies"; }
+
+private:
+  unsigned startLine = 0;
+};
+
+#endif // STRATEGY_VIEW_H
@@ -35,6 +35,63 @@ ArgParser::Error ArgParser::parseSingleArg(std::string arg) {
   } else if (consume(arg, "--reducer-tries=")) {
     reducerTries = std::stoul(arg);
     return {};
+  } else if (consume(arg, "--reducer-threads=")) {
+    reducerThreads = std::stoul(arg);
+    if (reducerThreads == 0)
+      return "Invalid or 0 passed to --reducer-threads=";
+    return {};
+  } else if (consume(arg, "--pipeline-depth=")) {
+    pipelineDepth = std::stoul(arg);
+    return {};
+  } else if (consume(arg, "--background-reductions=")) {
+    backgroundReductions = std::stoul(arg);
+    return {};
+  } else if (consume(arg, "--reduction-cpu-share=")) {
+    reductionCPUShare = std::stoul(arg);
+    if (reductionCPUShare == 0 || reductionCPUShare > 100)
+      return "--reduction-cpu-share= has to be between 1 and 100";
+    return {};
+  } else if (consume(arg, "--surrogate-skip=")) {
+    surrogateSkip = std::stoul(arg);
+    if (surrogateSkip >= 100)
+      return "--surrogate-skip= has to be between 0 and 99";
+    return {};
+  } else if (consume(arg, "--surrogate-exploration=")) {
+    surrogateExploration = std::stoul(arg);
+    if (surrogateExploration > 100)
+      return "--surrogate-exploration= has to be between 0 and 100";
+    return {};
+  } else if (consume(arg, "--max-similar=")) {
+    maxSimilar = std::stoul(arg);
+    return {};
+  } else if (consume(arg, "--similarity=")) {
+    similarity = std::stoul(arg);
+    if (similarity == 0 || similarity > 100)
+      return "--similarity= has to be between 1 and 100";
+    return {};
+  } else if (consume(arg, "--reductions-per-signature=")) {
+    reductionsPerSignature = std::stoul(arg);
+    return {};
+  } else if (consume(arg, "--dict-size=")) {
+    dictionarySize = std::stoul(arg);
+    return {};
+  } else if (consume(arg, "--max-nodes=")) {
+    maxNodes = std::stoul(arg);
+    return {};
+  } else if (consume(arg, "--max-bytes=")) {
+    maxBytes = std::stoul(arg);
+    return {};
+  } else if (consume(arg, "--max-depth=")) {
+    maxDepth = std::stoul(arg);
+    return {};
+  } else if (consume(arg, "--pre-oracle=")) {
+    if (arg.empty())
+      return "Have to specify a command to --pre-oracle=";
+    preOracles.push_back(arg);
+    return {};
+  } else if (consume(arg, "--feature-map-size=")) {
+    featureMapSize = std::stoul(arg);
+    return {};
   } else if (consume(arg, "--lang-opts=")) {
     optsFile = arg;
     if (optsFile.empty())
@@ -65,9 +122,137 @@ ArgParser::Error ArgParser::parseSingleArg(std::string arg) {
     if (stopAfterHits == 0)
       return "Invalid or 0 passed to --stop-after-hits=";
     return {};
+  } else if (consume(arg, "--evolve-every=")) {
+    evolveEvery = std::stoul(arg);
+    return {};
+  } else if (consume(arg, "--max-strategies=")) {
+    maxStrategies = std::stoul(arg);
+    if (maxStrategies == 0)
+      return "Invalid or 0 passed to --max-strategies=";
+    return {};
+  } else if (consume(arg, "--decision-learning-rate=")) {
+    decisionLearningRate = std::stof(arg);
+    if (decisionLearningRate < 0 || decisionLearningRate > 1)
+      return "--decision-learning-rate= has to be between 0 and 1";
+    return {};
+  } else if (consume(arg, "--power-schedule=")) {
+    Maybe<PowerSchedule> schedule = parsePowerSchedule(arg);
+    if (!schedule)
+      return schedule.getErrorMsg();
+    powerSchedule = *schedule;
+    return {};
+  } else if (consume(arg, "--materialized-programs=")) {
+    materializedPrograms = std::stoul(arg);
+    if (materializedPrograms == 0)
+      return "Invalid or 0 passed to --materialized-programs=";
+    return {};
+  } else if (consume(arg, "--result-store=")) {
+    resultStore = arg;
+    if (resultStore.empty())
+      return "Have to specify a path to --result-store=";
+    return {};
+  } else if (consume(arg, "--result-store-max-mb=")) {
+    resultStoreMaxMB = std::stoul(arg);
+    return {};
+  } else if (consume(arg, "--checkpoint-dir=")) {
+    checkpointDir = arg;
+    if (checkpointDir.empty())
+      return "Have to specify a directory to --checkpoint-dir=";
+    return {};
+  } else if (consume(arg, "--checkpoint-every=")) {
+    checkpointEvery = std::stoul(arg);
+    if (checkpointEvery == 0)
+      return "Invalid or 0 passed to --checkpoint-every=";
+    return {};
+  } else if (consume(arg, "--resume=")) {
+    resumeDir = arg;
+    if (resumeDir.empty())
+      return "Have to specify a checkpoint directory to --resume=";
+    return {};
+  } else if (consume(arg, "--seed-corpus=")) {
+    seedCorpus = arg;
+    if (seedCorpus.empty())
+      return "Have to specify a directory to --seed-corpus=";
+    return {};
+  } else if (consume(arg, "--seed-corpus-max=")) {
+    seedCorpusMax = std::stoul(arg);
+    if (seedCorpusMax == 0)
+      return "Invalid or 0 passed to --seed-corpus-max=";
+    return {};
+  } else if (consume(arg, "--sync-dir=")) {
+    syncDir = arg;
+    if (syncDir.empty())
+      return "Have to specify a directory to --sync-dir=";
+    return {};
+  } else if (consume(arg, "--sync-primary=")) {
+    syncName = arg;
+    syncPrimary = true;
+    if (syncName.empty())
+      return "Have to specify an instance name to --sync-primary=";
+    return {};
+  } else if (consume(arg, "--sync-secondary=")) {
+    syncName = arg;
+    syncPrimary = false;
+    if (syncName.empty())
+      return "Have to specify an instance name to --sync-secondary=";
+    return {};
+  } else if (consume(arg, "--sync-every=")) {
+    syncEvery = std::stoul(arg);
+    if (syncEvery == 0)
+      return "Invalid or 0 passed to --sync-every=";
+    return {};
+  } else if (consume(arg, "--sync-import-budget=")) {
+    syncImportBudget = std::stoul(arg);
+    return {};
+  } else if (consume(arg, "--cluster-coordinator=")) {
+    clusterCoordinator = arg;
+    if (clusterCoordinator.empty())
+      return "Have to specify an address to --cluster-coordinator=";
+    return {};
+  } else if (consume(arg, "--cluster-worker=")) {
+    clusterWorker = arg;
+    if (clusterWorker.empty())
+      return "Have to specify an address to --cluster-worker=";
+    return {};
+  } else if (consume(arg, "--cluster-batch=")) {
+    clusterBatch = std::stoul(arg);
+    if (clusterBatch == 0)
+      return "Invalid or 0 passed to --cluster-batch=";
+    return {};
+  } else if (consume(arg, "--cluster-job-timeout=")) {
+    clusterJobTimeout = std::stoul(arg);
+    return {};
+  } else if (consume(arg, "--islands=")) {
+    islands = std::stoul(arg);
+    if (islands == 0)
+      return "Invalid or 0 passed to --islands=";
+    return {};
+  } else if (consume(arg, "--migrate-every=")) {
+    migrateEvery = std::stoul(arg);
+    return {};
+  } else if (consume(arg, "--migrants=")) {
+    migrants = std::stoul(arg);
+    return {};
+  } else if (consume(arg, "--migration-topology=")) {
+    Maybe<MigrationTopology> topology = parseMigrationTopology(arg);
+    if (!topology)
+      return topology.getErrorMsg();
+    migrationTopology = *topology;
+    return {};
+  } else if (consume(arg, "--strategy-file=")) {
+    strategyFile = arg;
+    if (strategyFile.empty())
+      return "Have to specify a path to --strategy-file=";
+    return {};
   } else if (arg == "--no-wrap") {
     wrapMain = false;
     return {};
+  } else if (arg == "--compact-queue") {
+    compactQueue = true;
+    return {};
+  } else if (arg == "--crossover") {
+    crossover = true;
+    return {};
   } else if (arg == "--step") {
     manualStepping = true;
     return {};
@@ -102,5 +287,11 @@ ArgParser::Error ArgParser::parse(int argc, char **argv) {
   }
   if (args.empty())
     return "No oracle args. Please append them behind a '--'.";
+  if (!syncDir.empty() && syncName.empty())
+    return "--sync-dir= needs --sync-primary= or --sync-secondary=";
+  if (!clusterCoordinator.empty() && !clusterWorker.empty())
+    return "Can't be cluster coordinator and worker at the same time";
+  if (islands > 1 && (!clusterCoordinator.empty() || !clusterWorker.empty()))
+    return "--islands= can't be combined with cluster mode";
   return {};
 }
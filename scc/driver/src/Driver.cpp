@@ -1,6 +1,7 @@
 #include "scc/driver/Driver.h"
 
 #include <array>
+#include <atomic>
 #include <chrono>
 #include <cstdio>
 #include <ctime>
@@ -8,6 +9,7 @@
 #include <filesystem>
 #include <fstream>
 #include <iomanip>
+#include <csignal>
 #include <iostream>
 #include <list>
 #include <memory>
@@ -20,8 +22,10 @@
 #include <unistd.h>
 #include <utility>
 
+#include "scc/driver/views/IslandView.h"
 #include "scc/driver/views/MessageViewer.h"
 #include "scc/driver/views/StatusView.h"
+#include "scc/driver/views/StrategyView.h"
 
 #include "scc/driver/ColorOutput.h"
 #include "scc/driver/DrawTools.h"
@@ -29,40 +33,30 @@
 #include "scc/driver/Executor.h"
 #include "scc/driver/FancyProgramPrinter.h"
 #include "scc/driver/PretentiousUI.h"
+#include "scc/driver/SharedFeatureMap.h"
 #include "scc/mutator-utils/Scheduler.h"
 
 static Driver *globalDriver = nullptr;
 
-static bool printLast = true;
-
-static SchedulerBase::Feedback evalProg(const Program &p) {
-  auto &state = globalDriver->getState();
-  if (printLast)
-    state.lastProg = p;
-
-  SchedulerBase::Feedback result;
-
-  std::string outPath = "/tmp/gen_source" + std::to_string(getpid()) + "." +
-                        DriverUtils::getExtension(p);
+/// Set by SIGTERM to stop fuzzing after the current step.
+static volatile std::sig_atomic_t terminationRequested = 0;
 
-  // Delete the file at the end.
-  DriverUtils::FileCleanup cleanup(outPath);
+static void handleTermination(int) { terminationRequested = 1; }
 
-  state.printProg(p, outPath);
-  const std::string scoreNeedle = "FUZZ:SCORE:";
-  std::string feedbackStr;
-  size_t exeTime = 0;
-  {
-    DriverUtils::Timer timer(exeTime);
-    feedbackStr = Executor::exec(state.evalCommand + " " + outPath + " 2>&1");
-  }
-  state.execs += 1;
-  state.millisExe += exeTime;
+static bool printLast = true;
 
+/// Parses the output of an oracle into the given feedback.
+///
+/// @param preOracle True if the output is from a pre-oracle, which doesn't
+///                  have to report a score if it reports a dead end.
+static void parseFeedback(const std::string &feedbackStr,
+                          SchedulerBase::Feedback &result, bool preOracle) {
   auto now = std::chrono::system_clock::now();
   const std::time_t nowT = std::chrono::system_clock::to_time_t(now);
+  std::tm nowTm;
+  localtime_r(&nowT, &nowTm);
   std::stringstream timeS;
-  timeS << std::put_time(std::localtime(&nowT), "%T");
+  timeS << std::put_time(&nowTm, "%T");
   const std::string timeStr = timeS.str();
 
   auto addMsg = [&timeStr](std::string msg) {
@@ -75,25 +69,110 @@ static SchedulerBase::Feedback evalProg(const Program &p) {
     result.msg = *msg;
     addMsg(*msg);
   }
+  if (auto sig = Executor::getValue(feedbackStr, "FUZZ:SIG:"))
+    result.signature = *sig;
+  result.dictionary = Executor::getValues(feedbackStr, "FUZZ:DICT:");
 
+  const std::string scoreNeedle = "FUZZ:SCORE:";
   std::optional<std::string> scoreStr =
       Executor::getValue(feedbackStr, scoreNeedle);
   if (!scoreStr) {
+    if (preOracle && result.deadEnd)
+      return;
     result.interesting = true;
     addMsg("No score from oracle? Output: " + feedbackStr);
-    return result;
+    return;
   }
   try {
     result.score = std::stol(scoreStr->c_str());
   } catch (std::invalid_argument e) {
     result.interesting = true;
     addMsg("Oracle score not an int: " + *scoreStr);
-    return result;
   } catch (std::out_of_range e) {
     result.interesting = true;
     addMsg("Oracle score out of range: " + *scoreStr);
+  }
+}
+
+/// Runs the pre-oracles on the given file. Returns true if one of them
+/// rejected the program.
+static bool runPreOracles(const Program &p, const std::string &path,
+                          SchedulerBase::Feedback &result) {
+  auto &state = globalDriver->getState();
+  if (state.preOracles.empty())
+    return false;
+
+  const HashStream::Hash hash = ProgramCache::digest(p).hash;
+  for (const std::unique_ptr<OracleStage> &stage : state.preOracles) {
+    if (stage->passedBefore(hash)) {
+      stage->addCacheHit();
+      continue;
+    }
+    std::string output;
+    size_t exeTime = 0;
+    {
+      DriverUtils::Timer timer(exeTime);
+      output = Executor::exec(stage->getCommand() + " " + path + " 2>&1");
+    }
+    state.millisExe += exeTime;
+    const bool rejected = OracleStage::isRejection(output);
+    stage->addRun(hash, exeTime, rejected);
+    if (rejected) {
+      parseFeedback(output, result, /*preOracle=*/true);
+      return true;
+    }
+  }
+  return false;
+}
+
+static SchedulerBase::Feedback evalProg(const Program &p) {
+  auto &state = globalDriver->getState();
+  if (printLast)
+    state.setLastProg(p);
+
+  SchedulerBase::Feedback result;
+
+  // Every concurrent evaluation needs its own file.
+  static std::atomic<size_t> evalCounter = 0;
+  std::string outPath = "/tmp/gen_source" + std::to_string(getpid()) + "_" +
+                        std::to_string(evalCounter++) + "." +
+                        DriverUtils::getExtension(p);
+
+  // Delete the file at the end.
+  DriverUtils::FileCleanup cleanup(outPath);
+
+  state.printProg(p, outPath);
+  state.execs += 1;
+  if (runPreOracles(p, outPath, result))
     return result;
+
+  std::string feedbackStr;
+  size_t exeTime = 0;
+
+  // Every thread that evaluates programs needs its own feature map.
+  thread_local std::unique_ptr<SharedFeatureMap> featureMap;
+  std::string envPrefix;
+  if (state.featureMapSize != 0) {
+    if (!featureMap) {
+      auto created = SharedFeatureMap::create(state.featureMapSize);
+      if (created.isErr())
+        SCCError("Failed to create feature map: " + created.getErrorMsg());
+      featureMap = std::move(*created);
+    }
+    featureMap->clear();
+    envPrefix = featureMap->getEnvPrefix();
   }
+  {
+    DriverUtils::Timer timer(exeTime);
+    feedbackStr = Executor::exec(envPrefix + state.evalCommand + " " +
+                                 outPath + " 2>&1");
+  }
+  if (state.featureMapSize != 0)
+    result.features =
+        FeatureMap::collectFeatures(featureMap->data(), featureMap->size());
+  state.millisExe += exeTime;
+
+  parseFeedback(feedbackStr, result, /*preOracle=*/false);
   return result;
 }
 
@@ -125,6 +204,10 @@ void Driver::doSimpleUI() {
   std::cout << " | Score: " << std::setw(3) << scheduler.getBestScore();
   std::cout << " | Found interesting cases: " << std::setw(3)
             << scheduler.getNumFindings();
+  std::cout << " | Duplicates: " << std::setw(3)
+            << scheduler.getDuplicateFindings();
+  if (state.featureMapSize != 0)
+    std::cout << " | Features: " << std::setw(5) << scheduler.getNumFeatures();
   std::cout << " | Execs/s " << std::setw(4) << std::fixed
             << std::setprecision(2) << state.getExecsPerSec();
   std::cout << std::setw(0);
@@ -173,6 +256,8 @@ Driver::Driver(SchedulerBase &scheduler, std::string evalCommand,
 
   views.emplace_back(std::make_unique<StatusView>());
   views.emplace_back(std::make_unique<MessageViewer>());
+  views.emplace_back(std::make_unique<StrategyView>());
+  views.emplace_back(std::make_unique<IslandView>());
 
   lastUIUpdate = std::chrono::high_resolution_clock::now();
 }
@@ -187,17 +272,25 @@ void Driver::run(bool splash) {
 
   setbuf(stdout, nullptr);
 
+  // Stop cleanly on SIGTERM so a final checkpoint can be written. Restart
+  // interrupted system calls so running oracles aren't affected.
+  struct sigaction termAction = {};
+  termAction.sa_handler = handleTermination;
+  termAction.sa_flags = SA_RESTART;
+  sigaction(SIGTERM, &termAction, nullptr);
+
   if (splash)
     PretentiousUI::render();
 
   state.scheduler.setEvalFunction([](const Program &p) { return evalProg(p); });
   // Display the initial program on the UI.
-  state.lastProg = state.scheduler.getBestProg();
+  state.setLastProg(state.scheduler.getBestProg());
 
   std::chrono::steady_clock::time_point begin =
       std::chrono::steady_clock::now();
 
-  while (!state.scheduler.finished() && !exitRequested) {
+  while (!state.scheduler.finished() && !exitRequested &&
+         !terminationRequested) {
 
     if (canStep()) {
       ++state.iteration;
@@ -208,6 +301,8 @@ void Driver::run(bool splash) {
     auto toSave = state.scheduler.popInteresting();
     for (const Program &p : toSave)
       state.saveProg(p, "id_");
+    for (const std::string &err : state.scheduler.popErrors())
+      state.addMessage(err);
 
     handleInput();
     updateUIIfNecessary();
@@ -215,6 +310,9 @@ void Driver::run(bool splash) {
   if (!simpleUI)
     DriverUtils::clearScreen();
 
+  if (auto err = state.scheduler.writeCheckpoint())
+    std::cerr << "Failed to write checkpoint: " << err->getMessage() << "\n";
+
   std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
   std::cout << "Finished fuzzing!\n";
   std::cout << "Found bugs: " << state.savedCases << "\n";
@@ -1,8 +1,12 @@
 #include "scc/driver/DriverState.h"
 
 #include "scc/driver/DriverUtils.h"
+#include "scc/program/ProgramSerializer.h"
 
+#include <chrono>
+#include <ctime>
 #include <filesystem>
+#include <iomanip>
 #include <sstream>
 
 DriverState::DriverState(SchedulerBase &scheduler, std::string evalCommand,
@@ -33,16 +37,29 @@ OptError DriverState::printProg(const Program &p, std::string outPath) {
   return {};
 }
 
+void DriverState::addMessage(std::string msg) {
+  const std::time_t now =
+      std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+  std::tm nowTm;
+  localtime_r(&now, &nowTm);
+  std::stringstream timeS;
+  timeS << std::put_time(&nowTm, "%T");
+  addMessageWithTimestamp(msg, timeS.str());
+}
+
 void DriverState::saveProg(const Program &p, std::string prefix) {
   while (true) {
     ++savedCases;
-    std::string fileName = saveDir + "/" + prefix;
-    fileName += std::to_string(savedCases) + ".";
-    fileName += uniqueFileID + ".";
-    fileName += DriverUtils::getExtension(p);
+    std::string baseName = saveDir + "/" + prefix;
+    baseName += std::to_string(savedCases) + ".";
+    baseName += uniqueFileID + ".";
+    const std::string fileName = baseName + DriverUtils::getExtension(p);
     if (std::filesystem::exists(fileName))
       continue;
     printProg(p, fileName);
+    // Also store the IR so the case can be loaded again without parsing.
+    if (OptError err = ProgramSerializer::save(baseName + "scc", p))
+      addMessage("Failed to save program: " + err->getMessage());
     break;
   }
 }
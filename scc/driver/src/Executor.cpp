@@ -20,6 +20,23 @@ std::optional<std::string> Executor::getValue(std::string output,
   return rest.substr(0, endLine);
 }
 
+std::vector<std::string> Executor::getValues(const std::string &output,
+                                             const std::string &key) {
+  std::vector<std::string> res;
+  size_t lineStart = 0;
+  while (lineStart < output.size()) {
+    size_t lineEnd = output.find('\n', lineStart);
+    if (lineEnd == std::string::npos)
+      lineEnd = output.size();
+    if (output.compare(lineStart, key.size(), key) == 0 &&
+        lineEnd - lineStart >= key.size())
+      res.push_back(output.substr(lineStart + key.size(),
+                                  lineEnd - lineStart - key.size()));
+    lineStart = lineEnd + 1;
+  }
+  return res;
+}
+
 bool Executor::hasValue(std::string output, std::string key) {
   output = "\n" + output + "\n";
   key = "\n" + key + "\n";
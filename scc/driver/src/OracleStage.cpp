@@ -0,0 +1,27 @@
+#include "scc/driver/OracleStage.h"
+
+#include "scc/driver/Executor.h"
+
+#include <algorithm>
+
+bool OracleStage::isRejection(const std::string &output) {
+  return Executor::hasValue(output, "FUZZ:DEAD") ||
+         Executor::getValue(output, "FUZZ:SCORE:").has_value();
+}
+
+void OracleStage::addRun(HashStream::Hash hash, size_t m, bool rejected) {
+  ++runs;
+  millis += m;
+  if (rejected)
+    ++rejections;
+  else
+    survivors.isInCache(hash);
+}
+
+std::string OracleStage::getSummary() const {
+  const size_t r = runs;
+  return std::to_string(r) + " runs, " +
+         std::to_string(rejections * 100U / std::max<size_t>(r, 1)) +
+         "% rejected, " + std::to_string(millis / std::max<size_t>(r, 1)) +
+         " ms/run, " + std::to_string(cacheHits) + " cached";
+}
@@ -0,0 +1,48 @@
+#include "scc/driver/SharedFeatureMap.h"
+
+#include <atomic>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+Maybe<std::unique_ptr<SharedFeatureMap>>
+SharedFeatureMap::create(size_t size) {
+  if (size == 0)
+    return Err("Feature map can't be empty");
+
+  static std::atomic<size_t> mapCounter = 0;
+  const std::string name = "/scc-features-" + std::to_string(getpid()) + "-" +
+                           std::to_string(mapCounter++);
+  const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0)
+    return Err("Failed to create shared memory " + name + ": " +
+               std::strerror(errno));
+  if (ftruncate(fd, size) != 0) {
+    const std::string error = std::strerror(errno);
+    close(fd);
+    shm_unlink(name.c_str());
+    return Err("Failed to resize shared memory " + name + ": " + error);
+  }
+  void *mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  // The mapping keeps the memory alive.
+  close(fd);
+  if (mem == MAP_FAILED) {
+    shm_unlink(name.c_str());
+    return Err("Failed to map shared memory " + name);
+  }
+  return std::unique_ptr<SharedFeatureMap>(
+      new SharedFeatureMap(name, static_cast<uint8_t *>(mem), size));
+}
+
+SharedFeatureMap::~SharedFeatureMap() {
+  munmap(counters, mapSize);
+  shm_unlink(name.c_str());
+}
+
+void SharedFeatureMap::clear() { std::memset(counters, 0, mapSize); }
+
+std::string SharedFeatureMap::getEnvPrefix() const {
+  return std::string(nameVar) + "=" + name + " " + sizeVar + "=" +
+         std::to_string(mapSize) + " ";
+}
@@ -1,5 +1,7 @@
 #include "ArgParser.h"
+#include "Cluster.h"
 #include "Driver.h"
+#include "IslandScheduler.h"
 #include "SafeGenerator.h"
 #include "Scheduler.h"
 
@@ -23,15 +25,147 @@ int main(int argc, char **argv) {
   std::random_device d;
   size_t seed = d();
 
-  Scheduler<SafeGenerator> sched(seed);
-  sched.setMaxQueueSize(args.queueSize);
-  sched.setMaxRunLimit(args.tries);
-  sched.setMutatorScale(args.mutatorScale);
-  sched.setStopAfter(args.stopAfter);
+  // Every island has its own checkpoint, so the islands don't overwrite
+  // each other's checkpoints and don't all resume from the same state.
+  auto getIslandDir = [&args](const std::string &dir, size_t island) {
+    if (args.islands == 1)
+      return dir;
+    return dir + "/island-" + std::to_string(island);
+  };
 
-  Driver driver(
-      sched, args.getEvalCommand(), [&sched]() { sched.step(); }, ".");
+  // Sets up a scheduler from the arguments. Returns false on errors. Only
+  // the first island saves strategies and syncs with other instances.
+  auto configure = [&args, &getIslandDir](Scheduler<SafeGenerator> &sched,
+                                          size_t island) {
+    const bool first = island == 0;
+    sched.setMaxQueueSize(args.queueSize);
+    sched.setMaxRunLimit(args.tries);
+    sched.setPowerSchedule(args.powerSchedule);
+    sched.setCompactQueue(args.compactQueue);
+    sched.setMaterializedPrograms(args.materializedPrograms);
+    sched.setMutatorScale(args.mutatorScale);
+    sched.setStopAfter(args.stopAfter);
+    sched.setReducerThreads(args.reducerThreads);
+    sched.setPipelineDepth(args.pipelineDepth);
+    sched.setBackgroundReductions(args.backgroundReductions,
+                                  args.reductionCPUShare / 100.0);
+    sched.setReductionsPerSignature(args.reductionsPerSignature);
+    sched.setDictionaryCapacity(args.dictionarySize);
+    sched.setEvolveEvery(args.evolveEvery);
+    sched.setMaxStrategies(args.maxStrategies);
+    sched.setDecisionLearningRate(args.decisionLearningRate);
+    sched.setCrossover(args.crossover);
+    sched.setSurrogate(args.surrogateSkip / 100.0,
+                       args.surrogateExploration / 100.0);
+    sched.setDiversity(args.maxSimilar, args.similarity / 100.0);
+    if (args.maxNodes != 0)
+      sched.addCandidateFilter("max-nodes",
+                               CandidateFilter::maxNodes(args.maxNodes));
+    if (args.maxBytes != 0)
+      sched.addCandidateFilter("max-bytes",
+                               CandidateFilter::maxBytes(args.maxBytes));
+    if (args.maxDepth != 0)
+      sched.addCandidateFilter("max-depth",
+                               CandidateFilter::maxDepth(args.maxDepth));
+    if (!args.resultStore.empty())
+      if (auto err = sched.setResultStore(args.resultStore,
+                                          args.resultStoreMaxMB << 20)) {
+        std::cerr << "Failed to open result store: " << err->getMessage()
+                  << "\n";
+        return false;
+      }
+    // The other islands would overwrite the strategies of the first one.
+    if (first && !args.strategyFile.empty())
+      if (auto err = sched.setStrategyFile(args.strategyFile)) {
+        std::cerr << "Failed to load strategies: " << err->getMessage() << "\n";
+        return false;
+      }
+    if (!args.seedCorpus.empty())
+      if (auto err =
+              sched.loadSeedCorpus(args.seedCorpus, args.seedCorpusMax)) {
+        std::cerr << "Failed to load seed corpus: " << err->getMessage()
+                  << "\n";
+        return false;
+      }
+    if (first && !args.syncDir.empty())
+      if (auto err = sched.setCorpusSync(args.syncDir, args.syncName,
+                                         args.syncPrimary, args.syncEvery,
+                                         args.syncImportBudget)) {
+        std::cerr << "Failed to set up corpus sync: " << err->getMessage()
+                  << "\n";
+        return false;
+      }
+    // Keep writing checkpoints to the directory we resume from.
+    const std::string checkpointDir =
+        args.checkpointDir.empty() ? args.resumeDir : args.checkpointDir;
+    if (!checkpointDir.empty())
+      sched.setCheckpointDir(getIslandDir(checkpointDir, island),
+                             args.checkpointEvery);
+    if (!args.resumeDir.empty())
+      if (auto err = sched.resumeFrom(getIslandDir(args.resumeDir, island))) {
+        std::cerr << "Failed to resume: " << err->getMessage() << "\n";
+        return false;
+      }
+    return true;
+  };
+
+  std::vector<std::unique_ptr<Scheduler<SafeGenerator>>> schedulers;
+  for (size_t i = 0; i < args.islands; ++i) {
+    schedulers.push_back(std::make_unique<Scheduler<SafeGenerator>>(seed + i));
+    if (!configure(*schedulers.back(), i))
+      return 1;
+  }
+  auto islands =
+      std::make_unique<IslandScheduler<SafeGenerator>>(std::move(schedulers));
+  islands->setMigration(args.migrationTopology, args.migrateEvery,
+                        args.migrants);
+  Scheduler<SafeGenerator> &sched = islands->getFirstIsland();
+
+  Driver::StepFunc stepFunc = [&islands]() { islands->step(); };
+  std::unique_ptr<ClusterCoordinator> coordinator;
+  std::unique_ptr<ClusterWorker> worker;
+  if (!args.clusterCoordinator.empty()) {
+    auto listening = ClusterCoordinator::listen(
+        sched, [&sched]() { sched.step(); }, args.clusterCoordinator);
+    if (listening.isErr()) {
+      std::cerr << "Failed to start coordinator: " << listening.getErrorMsg()
+                << "\n";
+      return 1;
+    }
+    coordinator = std::move(*listening);
+    coordinator->setJobTimeout(args.clusterJobTimeout * 1000);
+    stepFunc = [&coordinator]() { coordinator->poll(10); };
+  } else if (!args.clusterWorker.empty()) {
+    auto connected =
+        ClusterWorker::connect(sched, args.clusterWorker, args.clusterBatch);
+    if (connected.isErr()) {
+      std::cerr << "Failed to connect to coordinator: "
+                << connected.getErrorMsg() << "\n";
+      return 1;
+    }
+    worker = std::move(*connected);
+    stepFunc = [&worker, &sched]() {
+      // Workers stop with the coordinator.
+      if (!worker->step())
+        sched.setStopAfter(0);
+    };
+  }
+
+  Driver driver(sched, args.getEvalCommand(), stepFunc, ".");
   driver.setUpdateInterval(args.uiUpdateMs);
+  driver.getState().featureMapSize = args.featureMapSize;
+  for (const std::string &cmd : args.preOracles)
+    driver.getState().preOracles.push_back(std::make_unique<OracleStage>(cmd));
+
+  if (args.islands > 1)
+    driver.getState().islands = islands.get();
 
   driver.run();
+  // The other islands use the oracle of the driver.
+  islands->stop();
+  // The driver only writes the final checkpoint of the first island.
+  for (size_t i = 1; i < islands->getNumIslands(); ++i)
+    if (auto err = islands->getIsland(i).writeCheckpoint())
+      std::cerr << "Failed to write checkpoint of island " << i << ": "
+                << err->getMessage() << "\n";
 }
@@ -0,0 +1,79 @@
+#include "scc/driver/views/IslandView.h"
+
+#include "scc/driver/DrawTools.h"
+#include "scc/driver/DriverUtils.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+/// Formats one row of the island table.
+static std::string formatIsland(const std::string &name,
+                                const IslandStats &s) {
+  std::stringstream line;
+  line << std::left << std::setw(8) << name << std::right << std::setw(12)
+       << s.iterations << std::setw(14);
+  // Islands whose queue is empty don't have a score.
+  if (s.bestScore == std::numeric_limits<SchedulerBase::Score>::min())
+    line << "-";
+  else
+    line << s.bestScore;
+  line << std::setw(10) << s.findings << std::setw(10) << s.features
+       << std::setw(12) << s.cacheHits << std::setw(10) << s.migrantsSent
+       << std::setw(10) << s.migrantsReceived;
+  return line.str();
+}
+
+void IslandView::draw(const DriverState &state) {
+  if (!state.islands) {
+    DrawTools::printHeader("No islands (see --islands=)", "█", "█");
+    return;
+  }
+  const std::vector<IslandStats> islands = state.islands->getIslandStats();
+
+  std::stringstream header;
+  header << std::left << std::setw(8) << "Island" << std::right
+         << std::setw(12) << "Iterations" << std::setw(14) << "Best score"
+         << std::setw(10) << "Findings" << std::setw(10) << "Features"
+         << std::setw(12) << "Cache hits" << std::setw(10) << "Sent"
+         << std::setw(10) << "Received";
+  DrawTools::printHeader(" Parallel islands ", "┏", "┓");
+  DrawTools::printLine(header.str());
+
+  IslandStats total;
+  total.bestScore = std::numeric_limits<SchedulerBase::Score>::min();
+  for (const IslandStats &s : islands) {
+    total.iterations += s.iterations;
+    total.bestScore = std::max(total.bestScore, s.bestScore);
+    total.cacheHits += s.cacheHits;
+    total.migrantsSent += s.migrantsSent;
+    total.migrantsReceived += s.migrantsReceived;
+    // Islands find the same features, so the sum would be misleading.
+    total.features = std::max(total.features, s.features);
+  }
+  // The first island also counts the findings of the other islands.
+  if (!islands.empty())
+    total.findings = islands.front().findings;
+  DrawTools::printLine(formatIsland("Total", total));
+
+  const unsigned maxLines = DriverUtils::getTerminalSize().ws_row - 6U;
+  if (startLine >= islands.size())
+    startLine = islands.size() - 1U;
+  for (size_t i = startLine; i < islands.size(); ++i) {
+    if (i - startLine >= maxLines)
+      break;
+    DrawTools::printLine(formatIsland("#" + std::to_string(i),
+                                      islands.at(i)));
+  }
+  DrawTools::printHeader("", "┗", "┛");
+}
+
+void IslandView::handleInput(const Input &input, DriverState &state) {
+  for (const Input::Key key : input.keys) {
+    if (key.isArrowUp() && startLine > 0)
+      --startLine;
+    if (key.isArrowDown())
+      ++startLine;
+  }
+}
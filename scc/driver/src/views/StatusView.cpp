@@ -21,8 +21,42 @@ void StatusView::draw(const DriverState &state) {
       std::to_string(scheduler.getCacheHits()) + " (" +
       std::to_string(scheduler.getCacheHitRate()) + "%) hit cache. Execs/s: " +
         execs.str());
-  DrawTools::printLine("Found interesting programs: " +
-                       std::to_string(scheduler.getNumFindings()));
+  DrawTools::printLine(
+      "Found interesting programs: " +
+      std::to_string(scheduler.getNumFindings()) + " (" +
+      std::to_string(scheduler.getUnfinishedReductions()) + " reducing, " +
+      std::to_string(scheduler.getDuplicateFindings()) + " duplicates of " +
+      std::to_string(scheduler.getNumSignatures()) + " signatures)");
+  std::string filtered;
+  for (const CandidateFilter::Filter &f :
+       scheduler.getCandidateFilter().getFilters())
+    filtered += (filtered.empty() ? "" : ", ") + f.name + " " +
+                std::to_string(f.rejections);
+  DrawTools::printLine("Rejected before the oracle: " + filtered);
+
+  if (const ResultStore *store = scheduler.getResultStore())
+    DrawTools::printLine(
+        "Result store: " + std::to_string(store->getNumResults()) +
+        " results, " + std::to_string(store->getHits()) + " reused");
+  if (const SurrogateModel *model = scheduler.getSurrogate())
+    DrawTools::printLine(
+        "Surrogate model: " + std::to_string(model->getSkipped()) +
+        " skipped, trained on " + std::to_string(model->getTrained()) +
+        " runs, precision " + std::to_string(model->getPrecision()) +
+        "%, recall " + std::to_string(model->getRecall()) + "%");
+
+  for (size_t i = 0; i < state.preOracles.size(); ++i)
+    DrawTools::printLine("Pre-oracle " + std::to_string(i + 1) + ": " +
+                         state.preOracles[i]->getSummary());
+  if (state.featureMapSize != 0)
+    DrawTools::printLine(
+        "Coverage features: " + std::to_string(scheduler.getNumFeatures()) +
+        " (" + std::to_string(scheduler.getNovelPrograms()) +
+        " programs queued for new coverage)");
+  if (scheduler.getMaxSimilarEntries() != 0)
+    DrawTools::printLine("Queue diversity: " +
+                         std::to_string(scheduler.getSimilarEvictions()) +
+                         " similar entries removed");
 
   DrawTools::printLine(
       "Current mutation strategy info: " + scheduler.getLastStratInfo() +
@@ -60,7 +94,7 @@ void StatusView::draw(const DriverState &state) {
     }
   }
 
-  const Program &p = printLast ? state.lastProg : scheduler.getBestProg();
+  const Program p = printLast ? state.getLastProg() : scheduler.getBestProg();
 
   if (printLast)
     DrawTools::printHeader(" Current test case ", "┗", "┛");
@@ -94,7 +128,7 @@ void StatusView::handleInput(const Input &input, DriverState &state) {
       state.saveProg(state.scheduler.getBestProg(), "saved_");
       break;
     case 'x':
-      state.saveProg(state.lastProg, "current_");
+      state.saveProg(state.getLastProg(), "current_");
       break;
 
     case ' ':
@@ -0,0 +1,72 @@
+#include "scc/driver/views/StrategyView.h"
+
+#include "scc/driver/DrawTools.h"
+#include "scc/driver/DriverUtils.h"
+
+#include <iomanip>
+#include <sstream>
+
+/// Formats the given microseconds as milliseconds.
+static std::string formatMillis(uint64_t micros) {
+  std::stringstream str;
+  str << std::fixed << std::setprecision(2) << (micros / 1000.0);
+  return str.str();
+}
+
+void StrategyView::draw(const DriverState &state) {
+  std::vector<NamedStrategyStats> strategies =
+      state.scheduler.getStrategyStats();
+  if (strategies.empty()) {
+    DrawTools::printHeader("No strategy statistics", "█", "█");
+    return;
+  }
+
+  // Most valuable strategies first.
+  std::stable_sort(
+      strategies.begin(), strategies.end(),
+      [](const NamedStrategyStats &l, const NamedStrategyStats &r) {
+        return l.stats.getPickWeight() > r.stats.getPickWeight();
+      });
+
+  std::stringstream header;
+  header << std::left << std::setw(24) << "Strategy" << std::right
+         << std::setw(10) << "Runs" << std::setw(8) << "Gain" << std::setw(8)
+         << "Rej%" << std::setw(11) << "Mut ms" << std::setw(11) << "Print ms"
+         << std::setw(12) << "Oracle ms" << std::setw(12) << "Gain/CPU-s"
+         << std::setw(8) << "Pick%";
+  DrawTools::printHeader(" Per-run cost of mutation strategies ", "┏", "┓");
+  DrawTools::printLine(header.str());
+
+  const unsigned maxLines = DriverUtils::getTerminalSize().ws_row - 5U;
+  if (startLine >= strategies.size())
+    startLine = strategies.size() - 1U;
+  for (size_t i = startLine; i < strategies.size(); ++i) {
+    if (i - startLine >= maxLines)
+      break;
+    const NamedStrategyStats &s = strategies.at(i);
+    std::string name = s.name;
+    name.resize(std::min<size_t>(name.size(), 23U));
+
+    std::stringstream line;
+    line << std::left << std::setw(24) << name << std::right << std::setw(10)
+         << s.stats.runs << std::setw(8) << s.stats.scoreGained << std::setw(8)
+         << s.stats.getRejectionRate() << std::setw(11)
+         << formatMillis(s.stats.perRun(s.stats.mutateMicros))
+         << std::setw(11) << formatMillis(s.stats.perRun(s.stats.printMicros))
+         << std::setw(12)
+         << formatMillis(s.stats.perRun(s.stats.oracleMicros))
+         << std::setw(12) << std::fixed << std::setprecision(3)
+         << s.stats.getGainPerCPUSecond() << std::setw(8) << s.chance;
+    DrawTools::printLine(line.str());
+  }
+  DrawTools::printHeader("", "┗", "┛");
+}
+
+void StrategyView::handleInput(const Input &input, DriverState &state) {
+  for (const Input::Key key : input.keys) {
+    if (key.isArrowUp() && startLine > 0)
+      --startLine;
+    if (key.isArrowDown())
+      ++startLine;
+  }
+}
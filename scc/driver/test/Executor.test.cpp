@@ -13,6 +13,14 @@ TEST(TestExecutor, TestGetValue) {
   EXPECT_EQ(Executor::getValue("NOTKEY:A\n", "KEY:"), None);
 }
 
+TEST(TestExecutor, TestGetValues) {
+  typedef std::vector<std::string> Values;
+  EXPECT_EQ(Executor::getValues("", "KEY:"), Values());
+  EXPECT_EQ(Executor::getValues("KEY:A\nKEY:B", "KEY:"), Values({"A", "B"}));
+  EXPECT_EQ(Executor::getValues("\nKEY:A\nNOTKEY:B\nKEY:\n", "KEY:"),
+            Values({"A", ""}));
+}
+
 TEST(TestExecutor, TestHasValue) {
   EXPECT_EQ(Executor::hasValue("KEYA", "KEY"), false);
   EXPECT_EQ(Executor::hasValue("AKEY", "KEY"), false);
@@ -0,0 +1,20 @@
+#include "scc/driver/OracleStage.h"
+#include "gtest/gtest.h"
+
+TEST(OracleStage, Rejection) {
+  EXPECT_TRUE(OracleStage::isRejection("error: foo\nFUZZ:SCORE:-5\n"));
+  EXPECT_TRUE(OracleStage::isRejection("FUZZ:DEAD"));
+  EXPECT_FALSE(OracleStage::isRejection(""));
+  EXPECT_FALSE(OracleStage::isRejection("FUZZ:MSG:ok\n"));
+}
+
+TEST(OracleStage, RemembersSurvivors) {
+  OracleStage stage("true");
+  stage.addRun(1, 10, /*rejected=*/true);
+  stage.addRun(2, 20, /*rejected=*/false);
+  EXPECT_FALSE(stage.passedBefore(1));
+  EXPECT_TRUE(stage.passedBefore(2));
+  EXPECT_EQ(stage.getRuns(), 2U);
+  EXPECT_EQ(stage.getRejections(), 1U);
+  EXPECT_EQ(stage.getSummary(), "2 runs, 50% rejected, 15 ms/run, 0 cached");
+}
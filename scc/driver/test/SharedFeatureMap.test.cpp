@@ -0,0 +1,30 @@
+#include "scc/driver/SharedFeatureMap.h"
+#include "scc/driver/Executor.h"
+#include "gtest/gtest.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+TEST(SharedFeatureMap, VisibleToOtherMappings) {
+  Maybe<std::unique_ptr<SharedFeatureMap>> map = SharedFeatureMap::create(16);
+  ASSERT_FALSE(map.isErr());
+  SharedFeatureMap &m = **map;
+
+  // Write through a second mapping like an oracle would do.
+  const int fd = shm_open(m.getName().c_str(), O_RDWR, 0);
+  ASSERT_GE(fd, 0);
+  void *mem = mmap(nullptr, m.size(), PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  ASSERT_NE(mem, MAP_FAILED);
+  static_cast<uint8_t *>(mem)[3] = 7;
+  munmap(mem, m.size());
+  EXPECT_EQ(m.data()[3], 7);
+
+  m.clear();
+  EXPECT_EQ(m.data()[3], 0);
+
+  const std::string env = Executor::exec(m.getEnvPrefix() + "env");
+  EXPECT_TRUE(Executor::hasValue(env, "SCC_FEATURE_MAP=" + m.getName()));
+  EXPECT_TRUE(Executor::hasValue(env, "SCC_FEATURE_MAP_SIZE=16"));
+}
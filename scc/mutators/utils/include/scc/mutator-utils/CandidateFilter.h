@@ -0,0 +1,61 @@
+#ifndef CANDIDATEFILTER_H
+#define CANDIDATEFILTER_H
+
+#include "ProgramCache.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+/// A chain of cheap in-process checks that reject mutated programs before
+/// they are sent to the (expensive) oracle.
+class CandidateFilter {
+public:
+  /// What the filters know about a candidate.
+  struct Candidate {
+    const Program &p;
+    /// The digest of the printed candidate. Always printable.
+    const ProgramCache::Digest &digest;
+    /// The hash of the program the candidate was derived from (or 0 if
+    /// unknown).
+    HashStream::Hash parentHash = 0;
+  };
+  /// Returns true if the candidate should be rejected.
+  typedef std::function<bool(const Candidate &)> RejectFunc;
+
+  struct Filter {
+    std::string name;
+    RejectFunc rejects;
+    /// How many candidates this filter rejected so far.
+    size_t rejections = 0;
+  };
+
+  /// Appends a filter to the end of the chain.
+  void add(std::string name, RejectFunc f);
+
+  /// Runs all filters until one rejects the candidate.
+  ///
+  /// @return True if the candidate was rejected.
+  bool rejects(const Candidate &c);
+
+  const std::vector<Filter> &getFilters() const { return filters; }
+
+  /// Rejects programs with more than the given number of nodes.
+  static RejectFunc maxNodes(size_t n);
+  /// Rejects programs whose source code is longer than the given number of
+  /// bytes.
+  static RejectFunc maxBytes(size_t n);
+  /// Rejects programs with statements nested deeper than the given depth.
+  static RejectFunc maxDepth(size_t n);
+  /// Rejects programs that use constructs their `LangOpts` don't allow (e.g.
+  /// exceptions in C or inline assembly if disabled).
+  static RejectFunc forbiddenConstructs();
+  /// Rejects programs that print exactly like the program they were derived
+  /// from.
+  static RejectFunc unchangedFromParent();
+
+private:
+  std::vector<Filter> filters;
+};
+
+#endif // CANDIDATEFILTER_H
@@ -0,0 +1,32 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "scc/utils/Error.h"
+#include "scc/utils/Maybe.h"
+
+#include <cstdint>
+#include <string>
+
+/// Stores the state of a scheduler in a directory, so that fuzzing can
+/// continue where it stopped after scc is killed.
+///
+/// The state is written to a temporary file that is then renamed, so the
+/// directory always contains the last complete checkpoint.
+class Checkpoint {
+public:
+  /// Increase when the stored scheduler state changes. Checkpoints with a
+  /// different version can't be resumed.
+  static constexpr uint64_t version = 2;
+
+  /// Returns the path of the checkpoint file in the given directory.
+  static std::string getPath(const std::string &dir);
+
+  /// Writes the given scheduler state to the checkpoint directory. Creates
+  /// the directory if necessary.
+  static OptError write(const std::string &dir, const std::string &state);
+
+  /// Returns the scheduler state from the given checkpoint directory.
+  static Maybe<std::string> read(const std::string &dir);
+};
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,202 @@
+#ifndef CLUSTER_H
+#define CLUSTER_H
+
+#include "SchedulerBase.h"
+#include "scc/utils/Maybe.h"
+#include "scc/utils/Stopwatch.h"
+
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+/// A stream socket that sends and receives length-prefixed frames.
+///
+/// Frames are only sent by `flush`, so several frames can be sent with a
+/// single syscall. The socket can be blocking or non-blocking.
+class ClusterConnection {
+  int fd;
+  /// Received bytes that don't form a complete frame yet.
+  std::string in;
+  /// Queued frames that weren't sent yet.
+  std::string out;
+
+  /// Returns the size of the next frame or 0 if its header wasn't received
+  /// yet.
+  size_t getPendingFrameSize() const;
+
+public:
+  /// Takes ownership of the given socket.
+  explicit ClusterConnection(int fd) : fd(fd) {}
+  ~ClusterConnection();
+
+  ClusterConnection(const ClusterConnection &) = delete;
+  ClusterConnection &operator=(const ClusterConnection &) = delete;
+
+  /// Connects to the given address. Addresses are either 'unix:PATH' or
+  /// 'tcp:HOST:PORT' where HOST is an IPv4 address.
+  static Maybe<std::unique_ptr<ClusterConnection>>
+  connect(const std::string &address);
+
+  int getFD() const { return fd; }
+
+  void queueFrame(std::string_view payload);
+  /// Sends the queued frames. A non-blocking socket only sends what fits
+  /// into its buffer and keeps the rest for the next call. Returns false if
+  /// the connection is broken.
+  bool flush();
+  /// Returns true if queued data wasn't sent yet.
+  bool hasPendingOutput() const { return !out.empty(); }
+
+  /// Reads the data that is available. A blocking socket blocks if there is
+  /// none. Returns false if the connection was closed or is broken, or if
+  /// the peer sends an implausibly large frame.
+  bool receive();
+  /// Returns the next complete frame that was received.
+  std::optional<std::string> popFrame();
+  /// Blocks until the next frame is received. Returns nothing if the
+  /// connection was closed before that.
+  std::optional<std::string> waitForFrame();
+};
+
+/// A listening socket for `ClusterConnection`s.
+class ClusterListener {
+  int fd;
+  /// The socket file of a Unix domain socket.
+  std::string unixPath;
+  std::string address;
+
+  ClusterListener(int fd, std::string unixPath, std::string address)
+      : fd(fd), unixPath(unixPath), address(address) {}
+
+public:
+  ~ClusterListener();
+
+  ClusterListener(const ClusterListener &) = delete;
+  ClusterListener &operator=(const ClusterListener &) = delete;
+
+  /// Listens on the given address (see `ClusterConnection::connect`). For
+  /// TCP, port 0 picks a free port.
+  static Maybe<std::unique_ptr<ClusterListener>>
+  listen(const std::string &address);
+
+  int getFD() const { return fd; }
+  /// Returns the address that workers can connect to.
+  const std::string &getAddress() const { return address; }
+
+  /// Returns a new non-blocking connection or null if no connection is
+  /// pending.
+  std::unique_ptr<ClusterConnection> accept();
+};
+
+/// Hands out the mutations of a scheduler to worker processes.
+///
+/// The coordinator owns the queue and the strategy statistics. Workers
+/// mutate and evaluate programs with their own oracle and push the feedback
+/// back. Each request of a worker carries the results of its last batch of
+/// jobs and asks for the next batch, so every round trip amortizes the
+/// syscalls over many jobs.
+///
+/// Workers can disconnect at any time. Their unfinished jobs are dropped
+/// and the coordinator continues with the remaining workers. Jobs of workers
+/// that hang are dropped after a timeout. Worker sockets are non-blocking,
+/// so a worker that doesn't read its replies can't stall the coordinator.
+class ClusterCoordinator {
+public:
+  typedef std::function<void()> StepFunc;
+
+private:
+  SchedulerBase &sched;
+  /// Steps the scheduler while it reduces or fuzzing finished.
+  StepFunc stepFunc;
+  std::unique_ptr<ClusterListener> listener;
+
+  struct Worker {
+    std::unique_ptr<ClusterConnection> conn;
+    /// The jobs the worker is running and since when.
+    std::map<uint64_t, Stopwatch> jobs;
+    /// The dictionary the worker has.
+    std::shared_ptr<const ConstantDictionary> dictionary;
+  };
+  std::list<Worker> workers;
+
+  /// After how many microseconds a job is dropped. 0 disables the timeout.
+  uint64_t jobTimeoutMicros = 600ULL * 1000 * 1000;
+
+  size_t completedJobs = 0;
+  size_t lostJobs = 0;
+  size_t lostWorkers = 0;
+  size_t timedOutJobs = 0;
+
+  ClusterCoordinator(SchedulerBase &sched, StepFunc stepFunc,
+                     std::unique_ptr<ClusterListener> listener)
+      : sched(sched), stepFunc(std::move(stepFunc)),
+        listener(std::move(listener)) {}
+
+  /// Applies the results in the request and sends the next batch. Returns
+  /// false if the request was malformed.
+  bool handleRequest(Worker &w, std::string_view request);
+  void dropWorker(std::list<Worker>::iterator w);
+  /// Drops the jobs that ran into the timeout. Their results are ignored
+  /// if they arrive later.
+  void dropTimedOutJobs();
+
+public:
+  /// The maximum number of jobs a worker gets at once.
+  static constexpr size_t maxBatchSize = 256;
+
+  /// Listens on the given address. The step function has to step the
+  /// scheduler, which reduces findings locally.
+  static Maybe<std::unique_ptr<ClusterCoordinator>>
+  listen(SchedulerBase &sched, StepFunc stepFunc, const std::string &address);
+
+  /// Accepts new workers and answers their requests. Waits at most the
+  /// given time for requests.
+  void poll(int timeoutMillis);
+
+  /// Drops jobs that a worker didn't finish within the given time. 0 means
+  /// that jobs are only dropped when their worker disconnects.
+  void setJobTimeout(uint64_t timeoutMillis) {
+    jobTimeoutMicros = timeoutMillis * 1000;
+  }
+
+  const std::string &getAddress() const { return listener->getAddress(); }
+  size_t getNumWorkers() const { return workers.size(); }
+  size_t getCompletedJobs() const { return completedJobs; }
+  /// Returns how many jobs were lost with their worker.
+  size_t getLostJobs() const { return lostJobs; }
+  /// Returns how many workers disconnected while running jobs.
+  size_t getLostWorkers() const { return lostWorkers; }
+  /// Returns how many jobs were dropped because of the job timeout.
+  size_t getTimedOutJobs() const { return timedOutJobs; }
+};
+
+/// Runs the jobs of a `ClusterCoordinator` with the given scheduler's
+/// generator, filters and fitness function.
+class ClusterWorker {
+  SchedulerBase &sched;
+  std::unique_ptr<ClusterConnection> conn;
+  size_t batchSize;
+  /// The results that are sent with the next request.
+  std::vector<SchedulerBase::ClusterResult> results;
+  size_t completedJobs = 0;
+
+  ClusterWorker(SchedulerBase &sched, std::unique_ptr<ClusterConnection> conn,
+                size_t batchSize)
+      : sched(sched), conn(std::move(conn)), batchSize(batchSize) {}
+
+public:
+  static Maybe<std::unique_ptr<ClusterWorker>>
+  connect(SchedulerBase &sched, const std::string &address, size_t batchSize);
+
+  /// Sends the results of the last batch and runs the next batch. Returns
+  /// false once the coordinator finished or is gone.
+  bool step();
+
+  size_t getCompletedJobs() const { return completedJobs; }
+};
+
+#endif // CLUSTER_H
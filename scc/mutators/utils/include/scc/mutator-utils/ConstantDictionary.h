@@ -0,0 +1,58 @@
+#ifndef CONSTANTDICTIONARY_H
+#define CONSTANTDICTIONARY_H
+
+#include "Rng.h"
+#include "scc/utils/BinaryStream.h"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+/// Constants that the oracle suggested via `FUZZ:DICT:<type>:<value>`.
+///
+/// The dictionary is bounded and deduplicated. Every time a constant is
+/// suggested again its frequency increases, which makes it more likely to be
+/// picked. When the dictionary is full, the least frequent constant is
+/// replaced.
+class ConstantDictionary {
+public:
+  struct Entry {
+    /// The name of the type, e.g., 'int'. '*' matches every type.
+    std::string type;
+    /// The constant as it should appear in the source code.
+    std::string value;
+    /// How often the oracle suggested this constant.
+    size_t frequency = 1;
+  };
+
+  /// Adds a constant or increases its frequency if it's already known.
+  void add(const std::string &type, const std::string &value);
+
+  /// Adds an entry in the format of the oracle command ('<type>:<value>').
+  ///
+  /// @return False if the entry is malformed.
+  bool addFromOracle(const std::string &entry);
+
+  /// Picks a random constant for the given type weighted by frequency.
+  std::optional<std::string> pick(Rng &rng, const std::string &type) const;
+
+  /// Sets the maximum number of stored constants.
+  void setCapacity(size_t c);
+
+  size_t size() const { return entries.size(); }
+
+  /// Writes the entries and their frequencies, but not the capacity.
+  void save(BinaryWriter &w) const;
+  void load(BinaryReader &r);
+  bool empty() const { return entries.empty(); }
+  const std::vector<Entry> &getEntries() const { return entries; }
+
+private:
+  std::vector<Entry> entries;
+  size_t capacity = 256;
+
+  /// Returns the entry that is replaced next.
+  std::vector<Entry>::iterator leastFrequent();
+};
+
+#endif // CONSTANTDICTIONARY_H
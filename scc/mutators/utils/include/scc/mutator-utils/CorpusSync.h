@@ -0,0 +1,58 @@
+#ifndef CORPUSSYNC_H
+#define CORPUSSYNC_H
+
+#include "scc/program/Program.h"
+#include "scc/utils/Error.h"
+#include "scc/utils/OutStream.h"
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+/// Exchanges programs between scc instances through a shared directory.
+///
+/// Every instance writes the programs it exports to its own subdirectory of
+/// the sync directory. The files are named after the program hash, so other
+/// instances can skip programs they've already seen without reading them.
+/// Files are written under a temporary name and then renamed, so readers
+/// never see half-written programs.
+///
+/// Like AFL's -M/-S modes, there is one primary instance that imports the
+/// programs of all instances. Secondary instances only import from the
+/// primary, so the number of scanned directories doesn't grow quadratically
+/// with the number of instances.
+class CorpusSync {
+  std::string dir;
+  std::string name;
+  bool primary = false;
+  /// Hashes of programs that were imported or exported.
+  std::unordered_set<HashStream::Hash> seen;
+  size_t exported = 0;
+  size_t imported = 0;
+
+  std::string getInstanceDir(const std::string &instance) const;
+  /// Returns the directories of the instances this instance imports from.
+  std::vector<std::string> getImportDirs() const;
+
+public:
+  /// The file in an instance directory that marks the primary instance.
+  static constexpr const char *primaryMarker = "primary";
+
+  CorpusSync(std::string dir, std::string name, bool primary);
+
+  /// Creates the directory of this instance.
+  OptError init();
+
+  /// Writes the given program to the directory of this instance. Does
+  /// nothing if the program was already imported or exported.
+  OptError exportProgram(const Program &p, HashStream::Hash hash);
+
+  /// Returns up to `budget` programs of other instances that weren't seen
+  /// before. Files that can't be read are skipped.
+  std::vector<Program> importNew(size_t budget);
+
+  size_t getExported() const { return exported; }
+  size_t getImported() const { return imported; }
+};
+
+#endif // CORPUSSYNC_H
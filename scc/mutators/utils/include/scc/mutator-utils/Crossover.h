@@ -0,0 +1,61 @@
+#ifndef CROSSOVER_H
+#define CROSSOVER_H
+
+#include "Rng.h"
+#include "scc/program/Program.h"
+#include "scc/utils/Maybe.h"
+
+#include <unordered_map>
+
+class GlobalVar;
+
+/// Copies declarations and statements from one program into another.
+///
+/// Identifiers and types only have a meaning within their own program, so
+/// everything that is copied is remapped to the identifier and type tables of
+/// the destination. Non-fixed identifiers get fresh names in the destination
+/// while fixed identifiers (builtin types/functions, main, ...) keep their
+/// name. Declarations and types the copied code depends on are copied along.
+class Crossover {
+public:
+  Crossover(Program &dst, const Program &src) : dst(dst), src(src) {}
+
+  /// Copies the given declaration of the source program (and everything it
+  /// depends on) into the destination.
+  ///
+  /// @return The copy in the destination.
+  Decl &transplantDecl(const Decl &d);
+
+  /// Returns a copy of the given statement of the source program that can be
+  /// inserted into any function of the destination.
+  ///
+  /// Fails if the statement depends on its surrounding function, e.g., by
+  /// using a local variable declared outside of it or by returning.
+  Maybe<Statement> transplantStatement(const Statement &s);
+
+  /// Copies a random function, global variable or statement from `src` into
+  /// `dst`. Statements are inserted into a random compound statement.
+  static OptError crossover(Program &dst, const Program &src, Rng &rng);
+
+private:
+  Program &dst;
+  const Program &src;
+  /// Maps identifiers of the source to the destination.
+  std::unordered_map<NameID, NameID> idMap;
+  /// Maps types of the source to the destination.
+  std::unordered_map<TypeRef, TypeRef> typeMap;
+
+  NameID mapID(NameID id);
+  TypeRef mapType(TypeRef t);
+  TypeRef mapBasicType(const Type &t);
+  TypeRef mapFunctionPointer(const Type &t);
+
+  /// Returns a copy of the statement that is remapped to the destination.
+  Statement remap(Statement s);
+
+  Decl &transplantFunction(const Function &f, NameID name);
+  Decl &transplantGlobal(const GlobalVar &g, NameID name);
+  Decl &transplantRecord(const Record &r, NameID name);
+};
+
+#endif // CROSSOVER_H
@@ -0,0 +1,42 @@
+#ifndef FEATUREMAP_H
+#define FEATUREMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "scc/utils/BinaryStream.h"
+
+/// Tracks which coverage features the oracle has reported so far.
+///
+/// Oracles can report the features (e.g., edges in an instrumented compiler)
+/// a program hits via a shared memory map of hit counters. Like in AFL, every
+/// counter is split into buckets (1, 2, 3, 4-7, 8-15, 16-31, 32-127, 128+)
+/// and every (counter, bucket) pair is a feature.
+class FeatureMap {
+public:
+  /// The number of buckets per counter.
+  static constexpr uint32_t bucketsPerCounter = 8;
+
+  /// Returns the features of a map of hit counters in ascending order.
+  static std::vector<uint32_t> collectFeatures(const uint8_t *counters,
+                                               size_t size);
+
+  /// Adds the given features to the set of known features.
+  ///
+  /// @return How many of the features were not known before.
+  size_t addFeatures(const std::vector<uint32_t> &features);
+
+  /// Returns the number of distinct features seen so far.
+  size_t getNumFeatures() const { return numFeatures; }
+
+  void save(BinaryWriter &w) const;
+  void load(BinaryReader &r);
+
+private:
+  /// Which features have been seen so far, indexed by feature.
+  std::vector<bool> seen;
+  size_t numFeatures = 0;
+};
+
+#endif // FEATUREMAP_H
@@ -0,0 +1,107 @@
+#ifndef HIERARCHICALREDUCER_H
+#define HIERARCHICALREDUCER_H
+
+#include "ProgramCache.h"
+#include "SchedulerBase.h"
+
+/// Deterministically reduces a program level by level (hierarchical delta
+/// debugging).
+///
+/// The passes are:
+///   1. Removing declarations (ddmin over all declarations except main).
+///   2. Removing statements (ddmin over the children of every compound
+///      statement, outer statements first).
+///   3. Replacing expressions with a constant or a child of the same type.
+/// The passes are repeated until none of them makes progress. Afterwards
+/// unused types are removed via the TypeGarbageCollector.
+///
+/// Candidates that can't be printed, reference removed declarations, are not
+/// smaller or were already seen are discarded without asking the oracle.
+class HierarchicalReducer {
+public:
+  typedef SchedulerBase::FeedbackFunc FeedbackFunc;
+
+  /// Statistics about the oracle usage.
+  struct Stats {
+    /// How often the oracle was called.
+    size_t oracleCalls = 0;
+    /// How many candidates were discarded without calling the oracle.
+    size_t skippedCandidates = 0;
+    /// How many candidates were still interesting.
+    size_t acceptedCandidates = 0;
+  };
+
+  HierarchicalReducer(FeedbackFunc feedback, const Program &p);
+
+  /// Tries candidates until the oracle was called once or the reduction is
+  /// finished.
+  ///
+  /// @return A textual description of what the step did.
+  std::string step();
+
+  /// Whether all passes are done.
+  bool finished() const { return level == Level::Done; }
+
+  /// Returns the smallest interesting program found so far.
+  const Program &getProgram() const { return current; }
+
+  const Stats &getStats() const { return stats; }
+
+  /// Location of a statement in the program: The index of the function in
+  /// the declaration list and the child indices starting from its body.
+  /// Copies of a program keep the order of its declarations, so a path is
+  /// valid in the copies of the program it was computed for.
+  struct NodePath {
+    size_t declIndex = 0;
+    std::vector<size_t> children;
+  };
+
+private:
+  enum class Level { Decls, Statements, Expressions, CollectTypes, Done };
+
+  FeedbackFunc feedback;
+  /// The smallest interesting program found so far.
+  Program current;
+  /// Printed size of `current`.
+  size_t currentSize = 0;
+  ProgramCache cache;
+  Stats stats;
+
+  Level level = Level::Decls;
+  /// Whether any candidate was accepted in the current round of passes.
+  bool progressInRound = false;
+
+  /// The compound statement or expression (by preorder index) the current
+  /// pass is working on.
+  size_t itemIndex = 0;
+  /// The ddmin granularity (0 means 'not started').
+  size_t chunks = 0;
+  /// The ddmin chunk that is removed next.
+  size_t chunkIndex = 0;
+  /// The replacement that is tried next for the current expression.
+  size_t replacementIndex = 0;
+
+  /// Result of trying one candidate.
+  enum class Outcome { Skipped, Rejected, Accepted };
+
+  /// Checks and evaluates the given candidate. Updates `current` if it is
+  /// accepted.
+  Outcome tryCandidate(Program &&candidate);
+
+  /// Advances the ddmin state after a candidate for a list of the given size
+  /// was tried. Returns true if the list is fully minimized.
+  bool advanceDDMin(Outcome o, size_t listSize);
+
+  /// Returns the range [begin, end) of the current ddmin chunk.
+  std::pair<size_t, size_t> getChunk(size_t listSize) const;
+
+  void nextLevel();
+
+  /// Each of these tries one candidate of the respective pass.
+  Outcome stepDecls();
+  Outcome stepStatements();
+  Outcome stepExpressions();
+  Outcome stepCollectTypes();
+};
+
+#endif // HIERARCHICALREDUCER_H
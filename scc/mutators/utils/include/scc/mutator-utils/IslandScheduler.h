@@ -0,0 +1,221 @@
+#ifndef ISLANDSCHEDULER_H
+#define ISLANDSCHEDULER_H
+
+#include "Scheduler.h"
+#include "scc/utils/Maybe.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// Which island the migrants of an island are sent to.
+enum class MigrationTopology {
+  /// Every island sends to the next one and the last one to the first.
+  Ring,
+  /// Every migration goes to a random other island.
+  Random,
+};
+
+/// Parses the name of a migration topology as used on the command line.
+Maybe<MigrationTopology> parseMigrationTopology(const std::string &name);
+
+/// Returns the command line name of a migration topology.
+std::string getMigrationTopologyName(MigrationTopology t);
+
+/// Returns the island that island `from` sends its migrants to. There have
+/// to be at least two islands.
+size_t pickMigrationTarget(MigrationTopology t, size_t from, size_t islands,
+                           Rng &rng);
+
+/// What an island reports about itself.
+struct IslandStats {
+  /// How often the island was stepped.
+  size_t iterations = 0;
+  SchedulerBase::Score bestScore = 0;
+  size_t findings = 0;
+  size_t features = 0;
+  size_t cacheHits = 0;
+  size_t migrantsSent = 0;
+  size_t migrantsReceived = 0;
+};
+
+/// The part of `IslandScheduler` that doesn't depend on the generator.
+///
+/// Every island has its own mailbox for migrants, findings and statistics,
+/// so islands never wait on a lock that all of them share.
+class IslandSchedulerBase {
+  struct Mailbox {
+    mutable std::mutex mutex;
+    /// Programs that migrate to this island.
+    std::vector<Program> migrants;
+    /// Findings of this island that the first island reports.
+    std::vector<Program> findings;
+    /// Errors of this island that the first island reports.
+    std::vector<std::string> errors;
+    /// The statistics the island published last.
+    IslandStats stats;
+  };
+  std::vector<std::unique_ptr<Mailbox>> mailboxes;
+
+protected:
+  MigrationTopology topology = MigrationTopology::Ring;
+  /// After how many iterations an island sends migrants. 0 disables
+  /// migration.
+  size_t migrateEvery = 5000;
+  /// How many of its best programs an island sends per migration.
+  size_t migrantsPerMigration = 2;
+
+  /// Sends the given programs from island `from` to another island.
+  void sendMigrants(size_t from, std::vector<Program> programs, Rng &rng);
+  /// Returns the programs that migrated to the given island.
+  std::vector<Program> takeMigrants(size_t island);
+  /// Returns the findings that the given island published.
+  std::vector<Program> takeFindings(size_t island);
+  /// Returns the errors that the given island published.
+  std::vector<std::string> takeErrors(size_t island);
+  /// Updates the statistics of the given island and hands its findings and
+  /// errors to the first island. The migration counters are kept.
+  void publish(size_t island, IslandStats stats, std::vector<Program> findings,
+               std::vector<std::string> errors);
+
+public:
+  explicit IslandSchedulerBase(size_t islands);
+  virtual ~IslandSchedulerBase() = default;
+
+  size_t getNumIslands() const { return mailboxes.size(); }
+
+  /// Sends the `count` best programs of every island to another island every
+  /// `every` iterations.
+  void setMigration(MigrationTopology t, size_t every, size_t count) {
+    topology = t;
+    migrateEvery = every;
+    migrantsPerMigration = count;
+  }
+
+  /// Returns the last published statistics of every island.
+  std::vector<IslandStats> getIslandStats() const;
+};
+
+/// Runs several independent schedulers ("islands") in parallel and
+/// periodically migrates the best programs between them.
+///
+/// Every island has its own queue, strategies, RNG and reducer threads. The
+/// first island is stepped by `step` on the caller's thread. It reports the
+/// findings of all islands and decides when fuzzing is finished, so it can
+/// be passed to code that expects a single scheduler (e.g. the driver). The
+/// other islands run on their own threads until they finish or the first
+/// island stops stepping them.
+template <typename GeneratorT>
+class IslandScheduler : public IslandSchedulerBase {
+public:
+  typedef Scheduler<GeneratorT> Island;
+
+private:
+  std::vector<std::unique_ptr<Island>> islands;
+
+  /// The state that only the thread of an island uses.
+  struct Local {
+    explicit Local(uint64_t seed) : rng(RngSource(seed)) {}
+    /// Picks the targets of random migrations.
+    Rng rng;
+    size_t iterations = 0;
+    size_t findings = 0;
+  };
+  std::vector<Local> locals;
+
+  std::vector<std::thread> threads;
+  std::atomic<bool> stopping = false;
+
+  void stepIsland(size_t i) {
+    Island &island = *islands.at(i);
+    Local &local = locals.at(i);
+    island.step();
+    ++local.iterations;
+    if (migrateEvery != 0 && local.iterations % migrateEvery == 0)
+      sendMigrants(i, island.getBestPrograms(migrantsPerMigration),
+                   local.rng);
+    std::vector<Program> arrived = takeMigrants(i);
+    if (!arrived.empty())
+      island.importPrograms(std::move(arrived));
+
+    // The first island reports its own findings and errors.
+    std::vector<Program> findings;
+    std::vector<std::string> errors;
+    if (i != 0) {
+      findings = island.popInteresting();
+      local.findings += findings.size();
+      errors = island.popErrors();
+    }
+    IslandStats stats;
+    stats.iterations = local.iterations;
+    stats.bestScore = island.getBestScore();
+    stats.findings = i == 0 ? island.getNumFindings() : local.findings;
+    stats.features = island.getNumFeatures();
+    stats.cacheHits = island.getCacheHits();
+    publish(i, stats, std::move(findings), std::move(errors));
+  }
+
+  void startThreads() {
+    if (!threads.empty() || islands.size() < 2)
+      return;
+    for (size_t i = 1; i < islands.size(); ++i) {
+      // The driver only sets the oracle of the first island.
+      if (!islands.at(i)->getEvalFunction())
+        islands.at(i)->setEvalFunction(islands.front()->getEvalFunction());
+      threads.emplace_back([this, i]() {
+        while (!stopping && !islands.at(i)->finished())
+          stepIsland(i);
+      });
+    }
+  }
+
+public:
+  /// Takes the given islands (at least one). They have to be configured
+  /// with different seeds.
+  explicit IslandScheduler(std::vector<std::unique_ptr<Island>> islands)
+      : IslandSchedulerBase(islands.size()), islands(std::move(islands)) {
+    SCCAssert(!this->islands.empty(), "Need at least one island");
+    // Random migrations only need to differ between islands.
+    for (size_t i = 0; i < this->islands.size(); ++i)
+      locals.emplace_back(/*seed=*/i);
+  }
+
+  ~IslandScheduler() override { stop(); }
+
+  IslandScheduler(const IslandScheduler &) = delete;
+  IslandScheduler &operator=(const IslandScheduler &) = delete;
+
+  /// Steps the first island and starts the other islands on their first
+  /// call. Findings and errors of the other islands are added to the first
+  /// island.
+  void step() {
+    startThreads();
+    stepIsland(0);
+    for (size_t i = 1; i < islands.size(); ++i) {
+      for (Program &p : takeFindings(i))
+        islands.front()->addFinding(std::move(p));
+      for (const std::string &err : takeErrors(i))
+        islands.front()->addError("Island " + std::to_string(i) + ": " + err);
+    }
+  }
+
+  /// Stops and joins the threads of the other islands.
+  void stop() {
+    stopping = true;
+    for (std::thread &t : threads)
+      t.join();
+    threads.clear();
+  }
+
+  /// Returns the island that is stepped by `step`.
+  Island &getFirstIsland() { return *islands.front(); }
+
+  /// Returns the given island. Only safe to use while the islands aren't
+  /// running.
+  Island &getIsland(size_t i) { return *islands.at(i); }
+};
+
+#endif // ISLANDSCHEDULER_H
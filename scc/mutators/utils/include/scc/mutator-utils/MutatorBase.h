@@ -1,6 +1,7 @@
 #ifndef MUTATORBASE_H
 #define MUTATORBASE_H
 
+#include "ConstantDictionary.h"
 #include "Rng.h"
 #include "StrategyInstance.h"
 #include "scc/program/BuiltinFunctions.h"
@@ -29,15 +30,18 @@ template <class Strategy> struct MutatorBase {
     StratInst &s;
     /// The Rng that is being used.
     RngSource rng;
-    MutatorData(Program &p, StratInst &s, RngSource rng)
-        : p(p), s(s), rng(rng) {}
+    /// Constants suggested by the oracle (or null if there are none).
+    const ConstantDictionary *dictionary = nullptr;
+    MutatorData(Program &p, StratInst &s, RngSource rng,
+                const ConstantDictionary *dictionary = nullptr)
+        : p(p), s(s), rng(rng), dictionary(dictionary) {}
   };
 
   MutatorBase(MutatorData &i)
       : p(i.p), idents(i.p.getIdents()), types(i.p.getTypes()),
         builtin(i.p.getBuiltin()), builtinFuncs(i.p.getBuiltinFuncs()),
         currentRng(i.rng.spawnChild()), strategy(i.s),
-        mutatorData(i.p, i.s, i.rng) {}
+        mutatorData(i.p, i.s, i.rng, i.dictionary) {}
 
   auto getTakenDecisions() const { return strategy.getTakenDecisions(); }
 
@@ -80,6 +84,25 @@ protected:
   /// Let the strategy pick a random action based on the provided weights.
   Frag pick(std::vector<Frag> l) { return strategy.pick(l); }
 
+  /// Returns a constant of the given type from the oracle's dictionary if
+  /// the strategy decides to use one.
+  ///
+  /// @param f The decision that controls how often dictionary constants are
+  ///          used instead of the mutator's own constants.
+  OptStmt pickDictionaryConstant(TypeRef t, Frag f) {
+    const ConstantDictionary *dict = mutatorData.dictionary;
+    if (!dict || dict->empty())
+      return {};
+    const Type &type = getType(stripCV(t));
+    if (type.getKind() != Type::Kind::Basic)
+      return {};
+    std::optional<std::string> value =
+        dict->pick(getRng(), idents.getName(type.getNameID()));
+    if (!value || !decision(f))
+      return {};
+    return Statement::Constant(*value, t);
+  }
+
   /// Returns a new identifier.
   IdentTable::NameID newID(std::string prefix = "i") {
     return idents.makeNewID(prefix);
@@ -0,0 +1,84 @@
+#ifndef POWERSCHEDULE_H
+#define POWERSCHEDULE_H
+
+#include "scc/utils/Maybe.h"
+
+#include <array>
+#include <cstddef>
+#include <string>
+
+/// How the scheduler distributes mutations over the programs in its queue.
+///
+/// Except for `Fixed`, these follow the power schedules from AFLFast: every
+/// time a queue entry is picked it gets an 'energy' (the number of mutations
+/// that are derived from it before moving on to the next entry).
+enum class PowerSchedule {
+  /// Always mutate the best program until it reaches the run limit and
+  /// escalate the `fixedPlateauLadder` when no progress is made.
+  Fixed,
+  /// Give most energy to high-scoring, small and fresh entries.
+  Exploit,
+  /// Like `Exploit` but with a smaller energy per pick, so the scheduler
+  /// cycles faster through the queue.
+  Explore,
+  /// Energy grows exponentially with the number of picks and shrinks with
+  /// the number of fruitless mutations derived from an entry.
+  Fast,
+  /// Like `Fast` but entries with more fruitless mutations than average are
+  /// skipped entirely.
+  Coe,
+};
+
+/// Parses the name of a power schedule as used on the command line.
+Maybe<PowerSchedule> parsePowerSchedule(const std::string &name);
+
+/// Returns the command line name of a power schedule.
+std::string getPowerScheduleName(PowerSchedule s);
+
+/// The metadata of a queue entry that its energy is computed from.
+struct QueueEntryStats {
+  /// Position in the queue sorted by score. 0 is the best entry.
+  size_t rank = 0;
+  size_t queueSize = 1;
+  /// Size of the program in nodes.
+  size_t nodes = 0;
+  size_t averageNodes = 0;
+  /// Non-cached iterations since the entry was added to the queue.
+  size_t age = 0;
+  size_t averageAge = 0;
+  /// How often the entry was picked by the schedule.
+  size_t picks = 0;
+  /// How many mutations of this entry did not lead to any progress.
+  size_t fruitlessRuns = 0;
+  size_t averageFruitlessRuns = 0;
+  /// How many coverage features the program hit.
+  size_t features = 0;
+  size_t averageFeatures = 0;
+};
+
+/// Returns how many mutations should be derived from a queue entry when it is
+/// picked. Never returns more than `maxEnergy`. 0 means the entry should be
+/// skipped.
+size_t computeEnergy(PowerSchedule s, const QueueEntryStats &e,
+                     size_t maxEnergy);
+
+/// A step of the desperation ladder used by `PowerSchedule::Fixed`.
+struct PlateauLevel {
+  /// The level applies after this many runs without any progress.
+  size_t runsWithoutProgress;
+  /// The size granularity used when sorting programs with equal scores.
+  unsigned desperation;
+  /// The maximum number of mutations applied at once.
+  unsigned mutatorScale;
+};
+
+/// The plateau levels of `PowerSchedule::Fixed`, in ascending order.
+constexpr std::array<PlateauLevel, 5> fixedPlateauLadder = {{
+    {20000, 32, 1},
+    {40000, 64, 1},
+    {80000, 128, 2},
+    {180000, 128, 3},
+    {300000, 256, 3},
+}};
+
+#endif // POWERSCHEDULE_H
@@ -2,10 +2,14 @@
 #define PROGRAMCACHE_H
 
 #include "scc/program/Program.h"
+#include "scc/utils/BinaryStream.h"
+
+#include <mutex>
 
 /// A cache of already seen programs.
 ///
 /// This is used to avoid re-running if we hit exactly the same program twice.
+/// All methods can be called concurrently from multiple threads.
 class ProgramCache {
   // TODO: This class should use de Bruijn indices for equivalence.
 
@@ -17,13 +21,45 @@ class ProgramCache {
   size_t queries = 0;
   /// How many queries hit the cache.
   size_t hashHits = 0;
+  /// Guards all members above.
+  mutable std::mutex mutex;
 
 public:
+  /// Everything the reducers need to know about a candidate, computed by
+  /// printing it only once.
+  struct Digest {
+    /// Whether the program could be printed. The other members are only
+    /// valid if this is true.
+    bool printable = false;
+    HashStream::Hash hash = 0;
+    /// See `HashStream::getContentHash`.
+    uint64_t contentHash = 0;
+    /// The size of the program in characters.
+    size_t size = 0;
+  };
+
+  /// Prints the program once to compute its digest.
+  static Digest digest(const Program &p) {
+    HashStream s;
+    Digest res;
+    res.printable = p.print(s).isSuccess();
+    res.hash = s.getHash();
+    res.contentHash = s.getContentHash();
+    res.size = s.getSize();
+    return res;
+  }
+
   /// Returns true if the program is in the cache.
   bool isInCacheNoInsert(const Program &p) const {
     HashStream s;
     OptError e = p.print(s);
-    return seenHashes.count(s.getHash()) != 0;
+    return isInCacheNoInsert(s.getHash());
+  }
+
+  /// Returns true if a program with the given hash is in the cache.
+  bool isInCacheNoInsert(HashStream::Hash hash) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return seenHashes.count(hash) != 0;
   }
 
   /// Returns true if the program is in the cache. If it's not in the cache
@@ -32,11 +68,15 @@ public:
   /// It's the callers responsibility to check that the program is in a
   /// printable state.
   bool isInCache(const Program &p) {
-    ++queries;
-
     HashStream s;
     p.print(s).assumeSuccess("Failed to print program in hash");
-    const HashStream::Hash hash = s.getHash();
+    return isInCache(s.getHash());
+  }
+
+  /// Same as above but takes the hash of an already printed program.
+  bool isInCache(HashStream::Hash hash) {
+    std::lock_guard<std::mutex> lock(mutex);
+    ++queries;
 
     // Check if we already seen this hash.
     if (seenHashes.count(hash) != 0) {
@@ -52,10 +92,21 @@ public:
   }
 
   /// Return the number of times the cache was hit.
-  size_t getCacheHits() const { return hashHits; }
+  size_t getCacheHits() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return hashHits;
+  }
 
   /// Returns the percentage chance (0-100) of how often the cache was hit.
-  size_t getCacheHitRate() const { return hashHits * 100U / (queries + 1U); }
+  size_t getCacheHitRate() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return hashHits * 100U / (queries + 1U);
+  }
+
+  /// Writes the seen hashes and the statistics.
+  void save(BinaryWriter &w) const;
+  /// Replaces the seen hashes and the statistics with the stored ones.
+  void load(BinaryReader &r);
 };
 
 #endif // PROGRAMCACHE_H
@@ -0,0 +1,75 @@
+#ifndef PROGRAMLINEAGE_H
+#define PROGRAMLINEAGE_H
+
+#include "scc/program/Program.h"
+
+#include <functional>
+#include <list>
+#include <memory>
+
+/// Describes how to rebuild a program without storing it.
+///
+/// A lineage is either a keyframe that stores the full program, or a mutation
+/// that can be replayed on the program of the parent lineage. As mutations
+/// are deterministic given the parent program, the seed, the strategy and
+/// the scale, replaying them yields exactly the same program.
+struct ProgramLineage {
+  typedef std::shared_ptr<const ProgramLineage> Ref;
+  /// Applies the mutation that turned the parent into this program.
+  typedef std::function<void(Program &)> ReplayFunc;
+
+  /// The program this one was mutated from. Null for keyframes.
+  Ref parent;
+  /// The full program. Only set for keyframes.
+  std::shared_ptr<const Program> keyframe;
+  /// The mutation to replay. Only set for non-keyframes.
+  ReplayFunc replay;
+  /// Hash of the printed program. Used to verify replays.
+  HashStream::Hash hash = 0;
+  /// How many mutations have to be replayed to rebuild this program.
+  size_t replayDepth = 0;
+
+  /// Creates a lineage that stores the given program.
+  static Ref makeKeyframe(const Program &p);
+
+  /// Creates a lineage for the given mutation of the parent.
+  ///
+  /// `p` is the result of the mutation. If the parent is already too far
+  /// away from its keyframe, this stores `p` as a new keyframe instead.
+  static Ref makeChild(Ref parent, ReplayFunc replay, const Program &p,
+                       size_t maxReplayDepth);
+
+  /// Returns the hash of the printed program.
+  static HashStream::Hash hashProgram(const Program &p);
+};
+
+/// A small LRU cache of programs rebuilt from their lineage.
+class MaterializedPrograms {
+  /// The most recently used program is at the front.
+  std::list<std::pair<ProgramLineage::Ref, std::shared_ptr<const Program>>>
+      entries;
+  size_t capacity = 16;
+  /// How many mutations were replayed in total.
+  size_t replays = 0;
+
+  /// Returns the cached program of the lineage or null.
+  std::shared_ptr<const Program> lookup(const ProgramLineage::Ref &l);
+
+public:
+  /// Returns the program described by the lineage.
+  ///
+  /// Rebuilds the program from the closest cached ancestor (or keyframe) if
+  /// it is not cached.
+  std::shared_ptr<const Program> get(const ProgramLineage::Ref &l);
+
+  /// Caches the given program for the given lineage.
+  void insert(const ProgramLineage::Ref &l, std::shared_ptr<const Program> p);
+
+  void setCapacity(size_t c);
+
+  void clear() { entries.clear(); }
+
+  size_t getReplays() const { return replays; }
+};
+
+#endif // PROGRAMLINEAGE_H
@@ -0,0 +1,36 @@
+#ifndef PROGRAMSKETCH_H
+#define PROGRAMSKETCH_H
+
+#include "scc/program/Program.h"
+
+#include <cstdint>
+#include <vector>
+
+/// A MinHash sketch of the structure of a program.
+///
+/// The structure is described by a set of shingles: the kind of every
+/// statement together with the kinds of its parent and grandparent, and the
+/// kinds of consecutive declarations. Comparing two sketches estimates how
+/// much the shingle sets of the programs overlap, which is cheap enough to
+/// compare every pair of queue entries.
+class ProgramSketch {
+public:
+  /// The number of hash functions. The error of `similarity` is roughly
+  /// 1/sqrt(numHashes).
+  static constexpr size_t numHashes = 64;
+
+  /// Computes the sketch of the given program.
+  static ProgramSketch compute(const Program &p);
+
+  /// True if the sketch wasn't computed.
+  bool empty() const { return minHashes.empty(); }
+
+  /// Estimates the Jaccard similarity of the shingles of both programs (0
+  /// to 1). Empty sketches aren't similar to anything.
+  double similarity(const ProgramSketch &o) const;
+
+private:
+  std::vector<uint32_t> minHashes;
+};
+
+#endif // PROGRAMSKETCH_H
@@ -1,7 +1,11 @@
 #ifndef REDUCER_H
 #define REDUCER_H
 
+#include "HierarchicalReducer.h"
 #include "SchedulerBase.h"
+#include "scc/utils/ThreadPool.h"
+
+#include <atomic>
 
 /// A scheduler specifically aimed at reducing a given program.
 ///
@@ -34,9 +38,9 @@ template <typename GeneratorT> class Reducer {
 
   /// Returns the size of the program.
   size_t getProgSize(const Program &p) {
-    OutString out;
+    CountingStream out;
     p.print(out).assumeSuccess("Failed to print to calculate size");
-    return out.getStr().size();
+    return out.getSize();
   }
 
   /// Maximum number of tries to mutate a program to find a smaller
@@ -56,12 +60,99 @@ template <typename GeneratorT> class Reducer {
   /// Cache of already seen reduced versions.
   ProgramCache cache;
 
+  /// Deterministic pass that runs before the random reduction strategies.
+  /// Null once it finished or if it is disabled.
+  std::unique_ptr<HierarchicalReducer> hierarchical;
+
+  /// Performs one step of the hierarchical pass and takes over its result
+  /// once it is done.
+  std::string hierarchicalStep() {
+    std::string res = hierarchical->step();
+    if (!hierarchical->finished())
+      return res;
+    toReduce = hierarchical->getProgram();
+    lastSize = getProgSize(toReduce);
+    cache.isInCache(toReduce);
+    hierarchical.reset();
+    return res;
+  }
+
+  /// The threads that evaluate candidates in parallel mode.
+  std::shared_ptr<ThreadPool> pool;
+  /// How many candidates are evaluated per step in parallel mode.
+  unsigned parallelCandidates = 1;
+  /// How many oracle calls were skipped because a smaller interesting
+  /// candidate was found in the meantime.
+  size_t cancelledCandidates = 0;
+
+  /// Evaluates several candidates concurrently and keeps the smallest one
+  /// that is still interesting.
+  std::string parallelStep(const std::string &res) {
+    // Mutating isn't thread-safe, so create all candidates up front. Every
+    // candidate uses a different strategy if possible.
+    std::vector<Program> candidates(parallelCandidates, toReduce);
+    const size_t firstStrat = rng.getBelow(strategies.size() - 1);
+    for (size_t i = 0; i < candidates.size(); ++i) {
+      const Strategy &strat =
+          strategies.at((firstStrat + i) % strategies.size());
+      gen.reduce(candidates.at(i), RngSource(rng.makeSeed()), strat);
+    }
+    triesLeft -= std::min<unsigned>(triesLeft, candidates.size() - 1);
+
+    // The size of the smallest interesting candidate so far. Workers skip
+    // their candidate once a smaller interesting one was found.
+    std::atomic<size_t> bestSize(lastSize);
+    std::atomic<size_t> cancelled(0);
+    std::vector<std::future<size_t>> results;
+    for (const Program &p : candidates) {
+      results.push_back(pool->submit([&p, &bestSize, &cancelled, this]() {
+        const size_t invalid = std::numeric_limits<size_t>::max();
+        const ProgramCache::Digest digest = ProgramCache::digest(p);
+        if (!digest.printable)
+          return invalid;
+        const size_t size = digest.size;
+        if (size >= lastSize || cache.isInCache(digest.hash))
+          return invalid;
+        if (size >= bestSize.load()) {
+          ++cancelled;
+          return invalid;
+        }
+        if (!feedback(p).interesting)
+          return invalid;
+        size_t best = bestSize.load();
+        while (size < best && !bestSize.compare_exchange_weak(best, size))
+          ;
+        return size;
+      }));
+    }
+
+    // Pick the smallest interesting candidate.
+    std::optional<size_t> bestIndex;
+    size_t bestCandidateSize = lastSize;
+    for (size_t i = 0; i < results.size(); ++i) {
+      const size_t size = results.at(i).get();
+      if (size >= bestCandidateSize)
+        continue;
+      bestCandidateSize = size;
+      bestIndex = i;
+    }
+    cancelledCandidates += cancelled;
+
+    if (!bestIndex)
+      return res + " - No candidate smaller and interesting";
+    toReduce = candidates.at(*bestIndex);
+    triesLeft = maxTries;
+    lastSize = bestCandidateSize;
+    return res;
+  }
+
 public:
   Reducer(FeedbackFunc feedback, uint64_t seed, const Program &p)
       : toReduce(p), rngSource(seed), rng(rngSource), feedback(feedback) {
     rng = Rng(rngSource);
     originalSize = lastSize = getProgSize(p);
     strategies = Strategy::makeReductionStrategies();
+    hierarchical = std::make_unique<HierarchicalReducer>(feedback, p);
   }
 
   /// Whether this reducer is done reducing.
@@ -79,29 +170,35 @@ public:
   std::string step() {
     if (finished())
       return "Done reducing";
+    if (hierarchical)
+      return hierarchicalStep();
     triesLeft -= 1;
     const std::string res =
         "Reducing (Tries left: " + std::to_string(triesLeft) + ", " +
         "Reduced size " + reducedPercentage() + "%) ";
 
+    if (pool && parallelCandidates > 1)
+      return parallelStep(res);
+
     Program p;
-    size_t newSize = 0;
+    // Printability, hash and size of `p` from a single print.
+    ProgramCache::Digest digest;
     for (unsigned i = 1; i <= mutateToReduceTries; ++i) {
       p = toReduce;
       const Strategy &strat = rng.pickOneVec(strategies);
-      auto taken = gen.reduce(p, rngSource, strat);
+      auto taken = gen.reduce(p, RngSource(rng.makeSeed()), strat);
+      digest = ProgramCache::digest(p);
 
       // If the program is malformed, skip it.
-      if (!p.canPrint())
+      if (!digest.printable)
         continue;
 
       // If we seen this before then retry.
-      if (cache.isInCacheNoInsert(p))
+      if (cache.isInCacheNoInsert(digest.hash))
         continue;
 
       // If the program is smaller than the last version then we reduced it.
-      newSize = getProgSize(p);
-      if (newSize < lastSize)
+      if (digest.size < lastSize)
         break;
 
       if (i == mutateToReduceTries)
@@ -109,14 +206,15 @@ public:
     }
 
     // Malformed program, ignore it.
-    if (!p.canPrint())
+    if (!digest.printable)
       return res + " - Failed to find program variant";
 
     // We already saw this reduced version, ignore it.
-    if (cache.isInCache(p))
+    if (cache.isInCache(digest.hash))
       return res + " - Hitting cache";
 
     // Program ended up being larger, ignore it.
+    const size_t newSize = digest.size;
     if (newSize >= lastSize)
       return res + " - Mutation was bigger: " + std::to_string(newSize) +
              " vs old " + std::to_string(lastSize);
@@ -137,8 +235,31 @@ public:
     triesLeft = t;
   }
 
+  /// Evaluates the given number of candidates per step in parallel on the
+  /// given threads. The feedback function has to be thread-safe.
+  void setParallel(std::shared_ptr<ThreadPool> threads, unsigned candidates) {
+    pool = threads;
+    parallelCandidates = candidates;
+  }
+
+  /// Enables or disables the deterministic hierarchical pass that runs before
+  /// the random reduction strategies. Has to be called before the first step.
+  void setHierarchical(bool enabled) {
+    if (enabled)
+      hierarchical = std::make_unique<HierarchicalReducer>(feedback, toReduce);
+    else
+      hierarchical.reset();
+  }
+
+  /// Returns how many oracle calls were skipped in parallel mode.
+  size_t getCancelledCandidates() const { return cancelledCandidates; }
+
   /// Returns the reduced program.
-  const Program &getProgram() const { return toReduce; }
+  const Program &getProgram() const {
+    if (hierarchical)
+      return hierarchical->getProgram();
+    return toReduce;
+  }
 };
 
 #endif // REDUCER_H
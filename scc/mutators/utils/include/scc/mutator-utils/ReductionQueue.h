@@ -0,0 +1,172 @@
+#ifndef REDUCTIONQUEUE_H
+#define REDUCTIONQUEUE_H
+
+#include "Reducer.h"
+#include "scc/utils/Stopwatch.h"
+
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <thread>
+
+/// Reduces interesting programs on background threads.
+///
+/// Findings are queued with `add` and the reduced programs can be collected
+/// with `popFinished` once their reduction is done. The feedback function
+/// has to be thread-safe as it is called from the background threads.
+template <typename GeneratorT> class ReductionQueue {
+  typedef SchedulerBase::FeedbackFunc FeedbackFunc;
+
+  FeedbackFunc feedback;
+  /// How many tries each reducer gets.
+  unsigned reducerTries;
+  /// The fraction of time a reduction thread is busy. The rest of the time
+  /// it sleeps to leave CPU time to the fuzzer.
+  double cpuShare = 1.0;
+
+  /// Optional threads for evaluating reduction candidates in parallel.
+  std::shared_ptr<ThreadPool> candidatePool;
+  unsigned parallelCandidates = 1;
+
+  struct Finding {
+    Program p;
+    uint64_t seed;
+    /// The bug signature that the reduced program has to keep.
+    std::string signature;
+  };
+
+  /// Guards all members below.
+  mutable std::mutex mutex;
+  std::condition_variable findingAvailable;
+  /// Findings that are waiting for a free reduction thread.
+  std::deque<Finding> pending;
+  /// Programs that are done reducing.
+  std::vector<Program> finished;
+  /// The findings that are currently being reduced.
+  std::list<Finding> running;
+  bool stopping = false;
+
+  std::vector<std::thread> workers;
+
+  void workerLoop() {
+    while (true) {
+      Finding finding;
+      typename std::list<Finding>::iterator self;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        findingAvailable.wait(
+            lock, [this]() { return stopping || !pending.empty(); });
+        if (stopping)
+          return;
+        finding = std::move(pending.front());
+        pending.pop_front();
+        self = running.insert(running.end(), finding);
+      }
+
+      Reducer<GeneratorT> reducer(
+          SchedulerBase::requireSignature(feedback, finding.signature),
+          finding.seed, finding.p);
+      reducer.setTries(reducerTries);
+      reducer.setParallel(candidatePool, parallelCandidates);
+      while (!reducer.finished() && !isStopping()) {
+        Stopwatch timer;
+        reducer.step();
+        if (cpuShare < 1.0) {
+          const double sleepMicros =
+              timer.getMicros() * (1.0 - cpuShare) / cpuShare;
+          std::this_thread::sleep_for(
+              std::chrono::microseconds((uint64_t)sleepMicros));
+        }
+      }
+
+      std::lock_guard<std::mutex> lock(mutex);
+      finished.push_back(reducer.getProgram());
+      running.erase(self);
+    }
+  }
+
+  bool isStopping() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stopping;
+  }
+
+public:
+  /// Creates a queue that runs up to `concurrency` reductions at once.
+  ReductionQueue(FeedbackFunc feedback, size_t concurrency,
+                 unsigned reducerTries)
+      : feedback(feedback), reducerTries(reducerTries) {
+    for (size_t i = 0; i < std::max<size_t>(1, concurrency); ++i)
+      workers.emplace_back([this]() { workerLoop(); });
+  }
+
+  /// Stops all reductions. Unfinished reductions are discarded.
+  ~ReductionQueue() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    findingAvailable.notify_all();
+    for (std::thread &t : workers)
+      t.join();
+  }
+
+  ReductionQueue(const ReductionQueue &) = delete;
+  ReductionQueue &operator=(const ReductionQueue &) = delete;
+
+  /// Sets the fraction (0-1] of time that each reduction thread may use.
+  void setCPUShare(double share) {
+    cpuShare = std::clamp(share, 0.01, 1.0);
+  }
+
+  /// Evaluates reduction candidates in parallel on the given threads.
+  void setParallel(std::shared_ptr<ThreadPool> threads, unsigned candidates) {
+    candidatePool = threads;
+    parallelCandidates = candidates;
+  }
+
+  /// Queues an interesting program for reduction. If `signature` is not
+  /// empty, the reduced program has to keep that bug signature.
+  void add(const Program &p, uint64_t seed,
+           const std::string &signature = "") {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      pending.push_back({p, seed, signature});
+    }
+    findingAvailable.notify_one();
+  }
+
+  /// Returns all programs that finished reducing since the last call.
+  std::vector<Program> popFinished() {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<Program> res;
+    res.swap(finished);
+    return res;
+  }
+
+  /// Returns the number of findings that are queued or being reduced.
+  size_t getUnfinished() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return pending.size() + running.size();
+  }
+
+  /// Returns the original programs of all findings that are queued or being
+  /// reduced.
+  std::vector<SchedulerBase::UnreducedFinding> getUnfinishedFindings() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<SchedulerBase::UnreducedFinding> res;
+    for (const Finding &f : running)
+      res.push_back({f.p, f.signature});
+    for (const Finding &f : pending)
+      res.push_back({f.p, f.signature});
+    return res;
+  }
+
+  /// Returns the number of findings that wait for a reduction thread.
+  size_t getPending() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return pending.size();
+  }
+};
+
+#endif // REDUCTIONQUEUE_H
@@ -0,0 +1,88 @@
+#ifndef RESULTSTORE_H
+#define RESULTSTORE_H
+
+#include "scc/utils/Maybe.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+/// A persistent database of oracle results keyed by program hash.
+/// Programs are identified by a hash of their printed form that depends on
+/// the order of the characters (see `HashStream::getContentHash`) and their
+/// printed size, which is checked on lookup.
+///
+/// The store is an append-only file of checksummed records that is read via
+/// mmap. Several processes can share one store: Records are appended with a
+/// single write and records appended by other processes are picked up on the
+/// next lookup that misses. Damaged records (e.g., of an append that
+/// crashed) are skipped. The file is never cut off, as the last record
+/// might still be appended by another process.
+/// All methods can be called concurrently from multiple threads.
+class ResultStore {
+public:
+  /// The stored part of an oracle result.
+  struct Result {
+    int64_t score = 0;
+    bool interesting = false;
+    bool deadEnd = false;
+    std::string msg;
+    std::string signature;
+  };
+
+  /// Opens (or creates) the store at the given path. Once the file reaches
+  /// `maxBytes`, no more results are appended.
+  static Maybe<std::unique_ptr<ResultStore>> open(const std::string &path,
+                                                  size_t maxBytes);
+  ~ResultStore();
+
+  ResultStore(const ResultStore &) = delete;
+  ResultStore &operator=(const ResultStore &) = delete;
+
+  /// Returns the stored result of the program with the given hash and
+  /// printed size.
+  std::optional<Result> lookup(uint64_t hash, uint64_t size);
+
+  /// Stores the result of the program with the given hash and printed size.
+  void store(uint64_t hash, uint64_t size, const Result &r);
+
+  /// Returns the number of known results.
+  size_t getNumResults() const;
+  /// Returns how many lookups found a result.
+  size_t getHits() const;
+
+private:
+  explicit ResultStore(int fd, size_t maxBytes) : fd(fd), maxBytes(maxBytes) {}
+
+  /// A result in the index. Strings are referenced by their hash.
+  struct Entry {
+    uint64_t size;
+    int64_t score;
+    uint64_t messageID;
+    uint64_t signatureID;
+    uint32_t flags;
+  };
+
+  int fd;
+  size_t maxBytes;
+  /// How far the file has been read.
+  size_t scannedBytes = 0;
+  std::unordered_map<uint64_t, Entry> index;
+  std::unordered_map<uint64_t, std::string> strings;
+  size_t hits = 0;
+  /// Guards all members above.
+  mutable std::mutex mutex;
+
+  /// Reads all records appended since the last scan. Stops at a record
+  /// that is still being appended.
+  void scanNewRecords();
+  /// Adds a string record if the string isn't known yet and returns its id.
+  uint64_t storeString(const std::string &s);
+  /// Appends a record to the file unless the store is full.
+  void append(uint16_t kind, const std::string &payload);
+};
+
+#endif // RESULTSTORE_H
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "scc/utils/BinaryStream.h"
 #include "scc/utils/SCCAssert.h"
 #include <algorithm>
 #include <cassert>
@@ -49,6 +50,11 @@ struct RngSource {
     return *this;
   }
 
+  /// Writes the position of the generator. Entrophy is not stored.
+  void save(BinaryWriter &w) const;
+  /// Continues at the position stored by `save`.
+  void load(BinaryReader &r);
+
 private:
   EntrophyVec *entrophy = nullptr;
   Seed seed = 0;
@@ -83,6 +89,9 @@ public:
     return result;
   }
 
+  void save(BinaryWriter &w) const { gen.save(w); }
+  void load(BinaryReader &r) { gen.load(r); }
+
   /// Returns a number below or equal the given max value.
   template <typename T> T getBelow(T max) {
     if (max == 0)
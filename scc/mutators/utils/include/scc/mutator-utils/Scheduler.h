@@ -1,12 +1,38 @@
 #ifndef SCHEDULER_H
 #define SCHEDULER_H
 
+#include <atomic>
 #include <deque>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <type_traits>
 
+#include "Crossover.h"
 #include "Reducer.h"
+#include "ReductionQueue.h"
 #include "SchedulerBase.h"
+#include "StrategyStats.h"
+#include "scc/program/ProgramSerializer.h"
+#include "scc/utils/Stopwatch.h"
+
+/// Whether the generator can use constants suggested by the oracle.
+template <typename GeneratorT, typename = void>
+struct AcceptsDictionary : std::false_type {};
+template <typename GeneratorT>
+struct AcceptsDictionary<
+    GeneratorT, std::void_t<decltype(std::declval<GeneratorT &>().setDictionary(
+                    std::shared_ptr<const ConstantDictionary>()))>>
+    : std::true_type {};
 
 /// Schedules mutations on a target program.
+///
+/// `GeneratorT::mutate` has to return the list of decisions that were taken
+/// during the mutation (like `GeneratorT::reduce`). These are used to learn
+/// which decisions lead to successful mutations.
+///
+/// If the generator has a `setDictionary` method, it is given the constants
+/// the oracle suggested before each mutation.
 template <typename GeneratorT> class Scheduler : public SchedulerBase {
   typedef typename GeneratorT::Strategy Strategy;
 
@@ -20,36 +46,30 @@ private:
   /// Groups a strategy and the scheduling metadata.
   struct StratAndMetadata {
     Strategy strat;
-    /// How many points we have gained by using this
-    /// mutation strategy.
-    size_t scoreGained = 0;
-    /// How often this strategy has been applied.
-    size_t runs = 1;
+    /// What using this strategy gained and cost so far.
+    StrategyStats stats;
+
+    /// Whether this entry stands for crossover between queue entries instead
+    /// of mutating with `strat`.
+    bool isCrossover = false;
+    /// Identifies the strategy while mutations that use it are running (0
+    /// until `getStrategyId` assigns one). Strategies that replace this one
+    /// get a new id.
+    uint64_t id = 0;
 
     StratAndMetadata() = default;
     StratAndMetadata(Strategy s) : strat(s) {}
 
-    /// When picking a random strategy, how much weight
-    /// should ge given to this program.
-    size_t getPickWeight() const {
-      return std::max<size_t>(1, scoreGained * 1000 / runs);
-    }
-
-    /// Called when this strategy has been used to do
-    /// a mutation.
-    /// \param gained How many points we gained by using
-    ///        this strategy (or 0 if we gained no additional points)
-    void didRun(size_t gained) {
-      ++runs;
-      scoreGained += gained;
+    static StratAndMetadata makeCrossover() {
+      StratAndMetadata res(Strategy::makeMutateStrategies().front());
+      res.strat.setName("crossover");
+      res.isCrossover = true;
+      return res;
     }
 
-    void hitCache() {
-      ++runs;
-      if (scoreGained == 0)
-        return;
-      scoreGained -= 1;
-    }
+    /// When picking a random strategy, how much weight
+    /// should ge given to this strategy.
+    size_t getPickWeight() const { return stats.getPickWeight(); }
 
     bool operator<(const StratAndMetadata &o) const {
       return getPickWeight() < o.getPickWeight();
@@ -94,21 +114,528 @@ private:
 
   size_t getRandomSeed() { return rng.makeSeed(); }
 
+  /// The number of non-cached iterations when the strategies were last
+  /// evolved.
+  size_t lastEvolution = 0;
+
+  /// Picks a strategy from the first `poolSize` strategies weighted by their
+  /// pick weight.
+  const Strategy &pickParentStrat(size_t poolSize) {
+    size_t weightSum = 0;
+    for (size_t i = 0; i < poolSize; ++i)
+      weightSum += strategies.at(i).getPickWeight();
+    size_t selected = rng.getBelow<size_t>(weightSum);
+    for (size_t i = 0; i < poolSize; ++i) {
+      const size_t weight = strategies.at(i).getPickWeight();
+      if (weight >= selected)
+        return strategies.at(i).strat;
+      selected -= weight;
+    }
+    return strategies.at(poolSize - 1U).strat;
+  }
+
+  /// Creates a new strategy by mutating/crossing over the given number of
+  /// best strategies.
+  Strategy makeOffspringStrat(size_t poolSize) {
+    Strategy child = pickParentStrat(poolSize);
+    if (poolSize > 1 && rng.flipCoin())
+      child.crossover(pickParentStrat(poolSize), rng);
+    child.randomize(rng);
+    return child;
+  }
+
+  /// Replaces underperforming strategies with offspring of the best
+  /// strategies.
+  void evolveStrategies() {
+    lastEvolution = nonCacheIterations;
+    // The strategy pointer might be invalidated below.
+    lastStrat = nullptr;
+
+    // Crossover has no decisions that could be evolved.
+    std::vector<StratAndMetadata> operators;
+    auto isOperator = [](const StratAndMetadata &s) { return s.isCrossover; };
+    std::copy_if(strategies.begin(), strategies.end(),
+                 std::back_inserter(operators), isOperator);
+    strategies.erase(
+        std::remove_if(strategies.begin(), strategies.end(), isOperator),
+        strategies.end());
+
+    // Best strategies first.
+    std::stable_sort(strategies.begin(), strategies.end(),
+                     [](const StratAndMetadata &l, const StratAndMetadata &r) {
+                       return r < l;
+                     });
+
+    const size_t elite = std::min(eliteStrategies, strategies.size());
+    const size_t parentPool = std::max<size_t>(elite, strategies.size() / 2);
+
+    // Replace the worst quarter of the strategies that had enough runs to
+    // judge them.
+    const size_t maxReplaced = std::max<size_t>(1, strategies.size() / 4);
+    size_t replaced = 0;
+    for (size_t i = strategies.size(); i > elite && replaced < maxReplaced;
+         --i) {
+      StratAndMetadata &s = strategies.at(i - 1U);
+      if (s.stats.runs < minStrategyRuns)
+        continue;
+      s = StratAndMetadata(makeOffspringStrat(parentPool));
+      ++replaced;
+    }
+
+    // Grow the population up to the cap with a new child.
+    if (strategies.size() < maxStrategies)
+      strategies.emplace_back(makeOffspringStrat(parentPool));
+    strategies.insert(strategies.end(), operators.begin(), operators.end());
+
+    if (!strategyFile.empty())
+      saveStrategies(strategyFile).assumeSuccess("Failed to save strategies");
+  }
+
+  void maybeEvolveStrategies() {
+    if (evolveEvery == 0)
+      return;
+    if (nonCacheIterations - lastEvolution < evolveEvery)
+      return;
+    evolveStrategies();
+  }
+
   void resetQueueToStart() {
     queue.clear();
+    materialized.clear();
     const unsigned initQueueSize = 3;
-    for (unsigned i = 0; i < initQueueSize; ++i)
-      addProgram(std::move(*gen.generate(RngSource(getRandomSeed()), opts)));
+    evaluateSeeds();
+    if (!addSeeds(initQueueSize))
+      for (unsigned i = 0; i < initQueueSize; ++i)
+        addProgram(
+            std::move(*gen.generate(RngSource(getRandomSeed()), opts)));
     sortQueue();
   }
 
   std::unique_ptr<Reducer<GeneratorT>> reducer;
+  /// The finding that `reducer` reduces.
+  UnreducedFinding reducerFinding;
+  /// Findings that are reduced after `reducer` is done. Cluster results can
+  /// report findings while a finding is reduced.
+  std::deque<UnreducedFinding> waitingFindings;
+  /// Reduces findings in the background. Only used if background reductions
+  /// are enabled.
+  std::unique_ptr<ReductionQueue<GeneratorT>> reductions;
+
+  /// Moves findings that finished reducing to the results.
+  void collectBackgroundReductions() {
+    if (!reductions)
+      return;
+    for (Program &p : reductions->popFinished()) {
+      numFindings += 1;
+      interestingResults.push_back(std::move(p));
+    }
+  }
 
-  void evaluateStrat(StratAndMetadata &strat, size_t points) {
-    strat.didRun(points);
+  /// Starts reducing the given interesting program. The reduced program has
+  /// to keep the given bug signature (if there is one).
+  void startReduction(const Program &p, const std::string &signature) {
+    if (backgroundReductions == 0) {
+      if (reducer) {
+        waitingFindings.push_back({p, signature});
+        return;
+      }
+      reducerFinding = {p, signature};
+      reducer.reset(new Reducer<GeneratorT>(
+          requireSignature(getEvalFunc(), signature), rng.makeSeed(), p));
+      reducer->setTries(reducerTries);
+      reducer->setParallel(reducerPool, reducerThreads);
+      return;
+    }
+    if (!reductions) {
+      reductions = std::make_unique<ReductionQueue<GeneratorT>>(
+          getEvalFunc(), backgroundReductions, reducerTries);
+      reductions->setCPUShare(reductionCPUShare);
+      reductions->setParallel(reducerPool, reducerThreads);
+    }
+    reductions->add(p, rng.makeSeed(), signature);
+  }
+
+  /// Records a run of the given strategy (null if it was replaced in the
+  /// meantime).
+  void evaluateStrat(StratAndMetadata *strat, size_t points) {
+    if (strat)
+      strat->stats.didRun(points);
     informAboutRun(points > 0);
   }
 
+  /// Transplants a random part of another queue entry into the given
+  /// program. Returns false if that failed.
+  bool crossoverWithOtherEntry(Program &p, size_t baseId) {
+    std::vector<const ProgAndMetadata *> others;
+    for (const ProgAndMetadata &e : queue)
+      if (e.id != baseId)
+        others.push_back(&e);
+    if (others.empty())
+      return false;
+    std::shared_ptr<const Program> other =
+        getEntryProgram(*rng.pickOneVec(others));
+    return Crossover::crossover(p, *other, rng).isSuccess();
+  }
+
+  /// Mutates the program with the given generator and dictionary of oracle
+  /// constants.
+  static std::vector<typename Strategy::Frag>
+  mutateWith(GeneratorT &g, Program &p, size_t seed, const Strategy &strat,
+             unsigned scale, std::shared_ptr<const ConstantDictionary> dict) {
+    if constexpr (AcceptsDictionary<GeneratorT>::value)
+      g.setDictionary(std::move(dict));
+    return g.mutate(p, RngSource(seed), strat, scale);
+  }
+
+  std::vector<typename Strategy::Frag>
+  mutateWith(Program &p, size_t seed, const Strategy &strat, unsigned scale,
+             std::shared_ptr<const ConstantDictionary> dict) {
+    return mutateWith(gen, p, seed, strat, scale, std::move(dict));
+  }
+
+  /// Called when a mutation was thrown away before reaching the oracle.
+  /// `strat` is null if the strategy was replaced in the meantime.
+  void rejectStrat(StratAndMetadata *strat) {
+    if (strat)
+      strat->stats.didReject();
+    informAboutRun(false);
+  }
+
+  /// Picks the queue entry that is mutated next. Returns a copy as the entry
+  /// is removed from the queue once it was picked too often.
+  ProgAndMetadata pickMutationBase() {
+    maybeEvolveStrategies();
+
+    if (resetRequest) {
+      resetRequest = false;
+      resetQueueToStart();
+    }
+
+    if (queue.empty())
+      resetQueueToStart();
+
+    maybeSyncCorpus();
+
+    ProgAndMetadata &picked = pickQueueEntry();
+    ProgAndMetadata res = picked;
+    picked.runs += 1;
+    if (powerSchedule == PowerSchedule::Fixed && picked.runs > maxRunLimit)
+      queue.pop_back();
+
+    if (queue.empty())
+      resetQueueToStart();
+    return res;
+  }
+
+  /// How a mutant was created from its base.
+  struct MutationRecipe {
+    size_t seed = 0;
+    Strategy strat;
+    unsigned scale = 1;
+    std::shared_ptr<const ConstantDictionary> dict;
+    /// Whether replaying the recipe on the base gives the mutant again.
+    /// Crossover depends on a second program, so it can't be replayed.
+    bool replayable = false;
+  };
+
+  /// A mutant that is waiting to be evaluated.
+  struct PreparedMutant {
+    ProgAndMetadata base;
+    /// The id of the used strategy. The strategies might be replaced before
+    /// the mutant is evaluated.
+    uint64_t strategyId = 0;
+    MutationRecipe recipe;
+    /// The base program until `produceMutant` mutated it.
+    Program p;
+    std::vector<typename Strategy::Frag> taken;
+    ProgramCache::Digest digest;
+    /// Whether crossover failed to create a mutant.
+    bool failed = false;
+    uint64_t mutateMicros = 0;
+    uint64_t printMicros = 0;
+  };
+
+  /// Picks the base and the strategy of the next mutation. Crossover is done
+  /// right away as it needs a second queue entry.
+  PreparedMutant planMutation() {
+    PreparedMutant m;
+    m.base = pickMutationBase();
+    StratAndMetadata &strat = pickStrat();
+    m.strategyId = getStrategyId(strat);
+    m.recipe.scale = std::max<unsigned>(1U, rng.getBelow(mutatorScale));
+    Stopwatch timer;
+    m.p = m.base.lineage ? *getEntryProgram(m.base) : m.base.p;
+    m.recipe.seed = getRandomSeed();
+    // Copy the strategy as it might change before the mutation is replayed.
+    m.recipe.strat = strat.strat;
+    // The feedback might replace the dictionary before the mutation is
+    // replayed.
+    m.recipe.dict = dictionary;
+    m.recipe.replayable = !strat.isCrossover;
+    if (strat.isCrossover)
+      m.failed = !crossoverWithOtherEntry(m.p, m.base.id);
+    m.mutateMicros = timer.lap();
+    return m;
+  }
+
+  /// Mutates and prints a planned mutant. Only uses the given generator, so
+  /// this can run on another thread.
+  static void produceMutant(GeneratorT &g, PreparedMutant &m) {
+    if (m.failed)
+      return;
+    Stopwatch timer;
+    if (m.recipe.replayable)
+      m.taken = mutateWith(g, m.p, m.recipe.seed, m.recipe.strat,
+                           m.recipe.scale, m.recipe.dict);
+    m.mutateMicros += timer.lap();
+    m.digest = ProgramCache::digest(m.p);
+    m.printMicros = timer.lap();
+  }
+
+  /// Filters the mutant, runs the oracle on it and handles its feedback.
+  void evaluateMutant(PreparedMutant &m) {
+    // The result is not credited to any strategy if the used strategy was
+    // replaced in the meantime.
+    StratAndMetadata *strat = findStrategy(m.strategyId);
+    if (strat)
+      strat->stats.mutateMicros += m.mutateMicros;
+    if (m.failed) {
+      markFruitless(m.base.id);
+      rejectStrat(strat);
+      return;
+    }
+    Program &p = m.p;
+
+    // Only set for candidates that are passed to the surrogate model.
+    SurrogateModel::Features surrogateFeatures;
+    SurrogateModel::Prediction prediction;
+
+    // Credits the decisions that produced this mutant.
+    auto learn = [&](bool success) {
+      if (strat && decisionLearningRate > 0)
+        strat->strat.reinforce(m.taken, success, decisionLearningRate);
+      if (surrogate && !surrogateFeatures.empty())
+        surrogate->train(surrogateFeatures, prediction, success);
+    };
+
+    Stopwatch timer;
+    bool rejected = !m.digest.printable;
+    if (!rejected) {
+      const CandidateFilter::Candidate candidate{p, m.digest, m.base.hash};
+      rejected = filters.rejects(candidate) || cache.isInCache(m.digest.hash);
+    }
+    const uint64_t printMicros = m.printMicros + timer.lap();
+    if (strat)
+      strat->stats.printMicros += printMicros;
+    if (rejected) {
+      learn(false);
+      markFruitless(m.base.id);
+      rejectStrat(strat);
+      return;
+    }
+
+    if (surrogate) {
+      surrogateFeatures = SurrogateModel::extract(p);
+      prediction = surrogate->predict(surrogateFeatures, rng);
+      if (prediction.skip) {
+        markFruitless(m.base.id);
+        rejectStrat(strat);
+        return;
+      }
+    }
+
+    nonCacheIterations++;
+
+    Feedback mutationFeedback = evaluate(p, m.digest);
+    const uint64_t oracleMicros = timer.lap();
+    if (strat)
+      strat->stats.oracleMicros += oracleMicros;
+    handleFeedback(strat, m.base, p, m.digest.hash, mutationFeedback, learn,
+                   m.recipe);
+  }
+
+  /// The arguments passed to `handleArgs`. Given to the producer's
+  /// generator.
+  std::vector<std::string> generatorArgs;
+  /// Creates the mutants of the pipeline. Only used by `producer`.
+  std::unique_ptr<GeneratorT> producerGen;
+  /// Incremented when the pipeline is discarded. Mutants of an older
+  /// generation are not produced anymore.
+  std::atomic<size_t> pipelineGeneration = 0;
+  /// The thread that produces the mutants of the pipeline.
+  std::unique_ptr<ThreadPool> producer;
+  /// The mutants created ahead of time in the order they were planned.
+  std::deque<std::future<PreparedMutant>> pipeline;
+
+  /// Plans mutations until the pipeline is full and hands them to the
+  /// producer thread.
+  void fillPipeline() {
+    if (!producer) {
+      producerGen = std::make_unique<GeneratorT>();
+      producerGen->handleArgs(generatorArgs)
+          .assumeSuccess("Failed to configure generator");
+      producer = std::make_unique<ThreadPool>(1);
+    }
+    while (pipeline.size() < pipelineDepth) {
+      pipeline.push_back(producer->submit(
+          [this, m = planMutation(),
+           generation = pipelineGeneration.load()]() mutable {
+            // Don't waste time on mutants that were already discarded.
+            if (generation == pipelineGeneration.load())
+              produceMutant(*producerGen, m);
+            return std::move(m);
+          }));
+    }
+  }
+
+  /// Throws away the mutants that were planned with an outdated queue.
+  void discardPipeline() {
+    ++pipelineGeneration;
+    discardedMutants += pipeline.size();
+    pipeline.clear();
+  }
+
+  /// Evaluates the oldest mutant of the pipeline while the producer thread
+  /// creates the next ones.
+  void stepPipelined() {
+    fillPipeline();
+    PreparedMutant m = pipeline.front().get();
+    pipeline.pop_front();
+    // Keep the producer busy while the oracle runs.
+    fillPipeline();
+    const size_t changesBefore = queueChanges;
+    evaluateMutant(m);
+    // The other mutants were picked from the old queue, which would now
+    // schedule differently.
+    if (queueChanges != changesBefore)
+      discardPipeline();
+  }
+
+  /// Updates the queue, the findings and the strategy with the oracle's
+  /// feedback on a mutant of `mutationBase`. `learn` credits the decisions
+  /// that produced the mutant. `strat` is null if the used strategy was
+  /// replaced in the meantime.
+  void handleFeedback(StratAndMetadata *strat,
+                      const ProgAndMetadata &mutationBase, Program &p,
+                      HashStream::Hash hash, const Feedback &mutationFeedback,
+                      const std::function<void(bool)> &learn,
+                      const MutationRecipe &recipe) {
+    auto padTo = [](unsigned size, std::string &s) {
+      if (s.size() >= size)
+        return;
+      s.resize(size, ' ');
+    };
+    updateDictionary(mutationFeedback);
+    if (strat) {
+      lastStratInfo = std::string(strat->strat.getName());
+      padTo(21, lastStratInfo);
+      lastStratInfo += " (Score: ";
+      lastStratInfo += std::to_string(strat->getPickWeight());
+      padTo(37, lastStratInfo);
+      lastStratInfo += " - Chance: ";
+      lastStratInfo +=
+          std::to_string(100 * strat->getPickWeight() / totalStratWeight()) +
+          "%)";
+    } else {
+      lastStratInfo = "Replaced strategy";
+    }
+
+    if (mutationFeedback.interesting) {
+      learn(true);
+      if (!signatures.addHit(mutationFeedback.signature, p.countNodes())) {
+        lastStratInfo = "Skipped duplicate of " + mutationFeedback.signature;
+        resetQueueToStart();
+        return;
+      }
+      lastStratInfo =
+          backgroundReductions ? "Queued finding for reduction" : "Reducing...";
+      startReduction(p, mutationFeedback.signature);
+      resetQueueToStart();
+      return;
+    }
+
+    if (mutationFeedback.deadEnd) {
+      learn(false);
+      markFruitless(mutationBase.id);
+      resetQueueToStart();
+      return;
+    }
+
+    ProgAndMetadata newQueueElem;
+    newQueueElem.programNodes = p.countNodes();
+    newQueueElem.score = mutationFeedback.score;
+    newQueueElem.message = mutationFeedback.msg;
+    newQueueElem.features = mutationFeedback.features.size();
+    newQueueElem.hash = hash;
+
+    // Programs that reach new coverage are kept even if they don't score
+    // better, as they are a different starting point for future mutations.
+    const bool novel = features.addFeatures(mutationFeedback.features) != 0;
+    const bool improved =
+        mutationFeedback.score > mutationBase.score ||
+        (mutationFeedback.score == mutationBase.score &&
+         mutationBase.sizeForSorting() > newQueueElem.sizeForSorting());
+    if (novel && !improved)
+      ++novelPrograms;
+    learn(improved || novel);
+    if (!improved && !novel) {
+      markFruitless(mutationBase.id);
+      evaluateStrat(strat, 0);
+      return;
+    }
+    evaluateStrat(strat, 10);
+    updateSketch(newQueueElem, p);
+
+    if (mutationBase.lineage && !recipe.replayable) {
+      newQueueElem.lineage = ProgramLineage::makeKeyframe(p);
+    } else if (mutationBase.lineage) {
+      auto replay = [this, recipe](Program &p) {
+        mutateWith(p, recipe.seed, recipe.strat, recipe.scale, recipe.dict);
+      };
+      newQueueElem.lineage = ProgramLineage::makeChild(
+          mutationBase.lineage, replay, p, maxReplayDepth);
+      // The new program is likely mutated again soon, so keep it around.
+      materialized.insert(newQueueElem.lineage,
+                          std::make_shared<const Program>(std::move(p)));
+    } else {
+      newQueueElem.setProgram(std::move(p));
+    }
+
+    enqueue(std::move(newQueueElem));
+
+    sortQueue();
+  }
+
+  /// A job that was handed to a cluster worker.
+  struct PendingClusterJob {
+    ProgAndMetadata base;
+    /// The id of the used strategy. The strategies might be reordered or
+    /// replaced until the result arrives.
+    uint64_t strategyId = 0;
+  };
+  std::map<uint64_t, PendingClusterJob> clusterJobs;
+  uint64_t nextClusterJobId = 1;
+
+  /// The id that is assigned to the next strategy. Every scheduler has its
+  /// own ids, so schedulers on different threads don't share a counter.
+  uint64_t nextStrategyId = 1;
+
+  /// Returns the id of the given strategy and assigns one if necessary.
+  uint64_t getStrategyId(StratAndMetadata &s) {
+    if (s.id == 0)
+      s.id = nextStrategyId++;
+    return s.id;
+  }
+
+  /// Returns the strategy with the given id or null if it was replaced in
+  /// the meantime.
+  StratAndMetadata *findStrategy(uint64_t id) {
+    for (StratAndMetadata &s : strategies)
+      if (s.id == id)
+        return &s;
+    return nullptr;
+  }
+
 public:
   Scheduler(FeedbackFunc feedback, uint64_t seed)
       : SchedulerBase(feedback, seed) {
@@ -130,6 +657,7 @@ public:
   }
 
   OptError handleArgs(std::vector<std::string> args) {
+    generatorArgs = args;
     return gen.handleArgs(args);
   }
 
@@ -152,8 +680,14 @@ public:
 
   /// Do one mutation->eval step.
   void step() {
-    if (finished())
+    collectBackgroundReductions();
+    if (fuzzingFinished()) {
+      // Don't busy-wait while the last findings are being reduced.
+      if (getUnfinishedReductions() != 0)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
       return;
+    }
+    maybeWriteCheckpoint();
     ++iterations;
 
     if (reducer) {
@@ -161,107 +695,314 @@ public:
         numFindings += 1;
         interestingResults.push_back(reducer->getProgram());
         reducer.reset();
+        reducerFinding = {};
+        if (!waitingFindings.empty()) {
+          UnreducedFinding next = std::move(waitingFindings.front());
+          waitingFindings.pop_front();
+          startReduction(next.p, next.signature);
+        }
         return;
       }
       lastStratInfo = reducer->step();
       return;
     }
 
-    if (resetRequest) {
-      resetRequest = false;
-      resetQueueToStart();
+    if (pipelineDepth != 0) {
+      stepPipelined();
+      return;
     }
+    PreparedMutant m = planMutation();
+    produceMutant(gen, m);
+    evaluateMutant(m);
+  }
 
-    if (queue.empty())
-      resetQueueToStart();
+  bool isReducing() const override { return reducer.get() != nullptr; }
 
-    ProgAndMetadata mutationBase = queue.back();
-    StratAndMetadata &strat = pickStrat();
+  size_t getUnfinishedReductions() const override {
+    return reductions ? reductions->getUnfinished() : 0;
+  }
 
-    queue.back().runs += 1;
-    if (queue.back().runs > maxRunLimit)
-      queue.pop_back();
+  const Program &getBestProg() override {
+    if (reducer)
+      return reducer->getProgram();
+    SCCAssert(!queue.empty(), "No best program available?");
+    if (!queue.back().lineage)
+      return queue.back().p;
+    pinnedBestProg = getEntryProgram(queue.back());
+    return *pinnedBestProg;
+  }
 
+  std::string getBestProcMsg() const override {
     if (queue.empty())
-      resetQueueToStart();
+      return "";
+    return queue.back().message;
+  }
 
-    auto usedScale = std::max<unsigned>(1U, rng.getBelow(mutatorScale));
-    Program p = mutationBase.p;
-    gen.mutate(p, RngSource(getRandomSeed()), strat.strat, usedScale);
+  Strategy *getLastStrat() const { return lastStrat; }
 
-    if (!p.canPrint() || cache.isInCache(p)) {
-      evaluateStrat(strat, 0);
-      return;
+  std::vector<NamedStrategyStats> getStrategyStats() const override {
+    std::vector<NamedStrategyStats> res;
+    const size_t totalWeight = totalStratWeight();
+    for (const StratAndMetadata &s : strategies) {
+      NamedStrategyStats info;
+      info.name = std::string(s.strat.getName());
+      info.stats = s.stats;
+      info.chance = 100 * s.getPickWeight() / totalWeight;
+      res.push_back(info);
     }
+    return res;
+  }
 
-    nonCacheIterations++;
-
-    auto padTo = [](unsigned size, std::string &s) {
-      if (s.size() >= size)
-        return;
-      s.resize(size, ' ');
-    };
-    Feedback mutationFeedback = evalFunc(p);
-    lastStratInfo = std::string(strat.strat.getName());
-    padTo(21, lastStratInfo);
-    lastStratInfo += " (Score: ";
-    lastStratInfo += std::to_string(strat.getPickWeight());
-    padTo(37, lastStratInfo);
-    lastStratInfo += " - Chance: ";
-    lastStratInfo +=
-        std::to_string(100 * strat.getPickWeight() / totalStratWeight()) + "%)";
+  GeneratorT &getGenerator() { return gen; }
 
-    if (mutationFeedback.interesting) {
-      lastStratInfo = "Reducing...";
-      reducer.reset(new Reducer<GeneratorT>(evalFunc, rng.makeSeed(), p));
-      reducer->setTries(reducerTries);
-      resetQueueToStart();
-      return;
+  /// Writes the current strategies to the given file.
+  OptError saveStrategies(std::string path) const {
+    const std::string tmpPath = path + ".tmp";
+    {
+      std::ofstream out(tmpPath);
+      for (const StratAndMetadata &s : strategies)
+        if (!s.isCrossover)
+          out << s.strat.serialize() << "\n";
+      if (!out)
+        return Err("Failed to write strategies to " + tmpPath);
     }
+    // Rename so that we never leave a half-written file behind.
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec)
+      return Err("Failed to rename " + tmpPath + ": " + ec.message());
+    return {};
+  }
 
-    if (mutationFeedback.deadEnd) {
-      resetQueueToStart();
-      return;
+  /// Replaces the current strategies with the ones stored in the given file.
+  OptError loadStrategies(std::string path) {
+    std::ifstream in(path);
+    if (!in)
+      return Err("Failed to open strategy file " + path);
+
+    std::vector<StratAndMetadata> loaded;
+    std::string line;
+    while (std::getline(in, line)) {
+      if (line.empty())
+        continue;
+      // Start with a default strategy so the number of decisions matches.
+      Strategy s = Strategy::makeMutateStrategies().front();
+      if (OptError err = s.deserialize(line))
+        return err;
+      loaded.emplace_back(s);
     }
+    if (loaded.empty())
+      return Err("No strategies in strategy file " + path);
+    strategies = loaded;
+    if (crossover)
+      strategies.push_back(StratAndMetadata::makeCrossover());
+    lastStrat = nullptr;
+    return {};
+  }
 
-    ProgAndMetadata newQueueElem;
-    newQueueElem.setProgram(std::move(p));
-    newQueueElem.score = mutationFeedback.score;
-    newQueueElem.message = mutationFeedback.msg;
+  void setCrossover(bool v) override {
+    crossover = v;
+    strategies.erase(std::remove_if(strategies.begin(), strategies.end(),
+                                    [](const StratAndMetadata &s) {
+                                      return s.isCrossover;
+                                    }),
+                     strategies.end());
+    if (crossover)
+      strategies.push_back(StratAndMetadata::makeCrossover());
+    lastStrat = nullptr;
+  }
 
-    if (mutationFeedback.score > mutationBase.score) {
-      evaluateStrat(strat, 10);
-    } else if (mutationFeedback.score == mutationBase.score &&
-               mutationBase.sizeForSorting() > newQueueElem.sizeForSorting()) {
-      evaluateStrat(strat, 10);
-    } else {
-      evaluateStrat(strat, 0);
-      return;
-    }
+  OptError setStrategyFile(std::string path) override {
+    strategyFile = path;
+    if (!std::filesystem::exists(path))
+      return {};
+    return loadStrategies(path);
+  }
 
-    queue.emplace_back(newQueueElem);
+  OptError writeCheckpoint() override {
+    if (checkpointDir.empty())
+      return {};
+    lastCheckpoint = nonCacheIterations;
+    BinaryWriter w;
+    saveBaseState(w);
+    w.writeUInt(lastEvolution);
+    w.writeUInt(strategies.size());
+    for (const StratAndMetadata &s : strategies) {
+      w.writeBool(s.isCrossover);
+      w.writeString(s.strat.serialize());
+      s.stats.save(w);
+    }
 
-    sortQueue();
+    // Reductions are restarted from the original finding.
+    std::vector<UnreducedFinding> unreduced;
+    if (reducer)
+      unreduced.push_back(reducerFinding);
+    unreduced.insert(unreduced.end(), waitingFindings.begin(),
+                     waitingFindings.end());
+    if (reductions) {
+      auto queued = reductions->getUnfinishedFindings();
+      unreduced.insert(unreduced.end(), queued.begin(), queued.end());
+    }
+    w.writeUInt(unreduced.size());
+    for (const UnreducedFinding &f : unreduced) {
+      ProgramSerializer::write(w, f.p);
+      w.writeString(f.signature);
+    }
+    return Checkpoint::write(checkpointDir, w.getData());
   }
 
-  bool isReducing() const override { return reducer.get() != nullptr; }
+  OptError resumeFrom(const std::string &dir) override {
+    Maybe<std::string> state = Checkpoint::read(dir);
+    if (state.isErr())
+      return state.takeError();
+    BinaryReader r(*state);
+    loadBaseState(r);
+    lastEvolution = r.readUInt();
+
+    std::vector<StratAndMetadata> loaded;
+    const size_t numStrategies = r.readSize();
+    for (size_t i = 0; i < numStrategies && !r.hasFailed(); ++i) {
+      const bool isCrossover = r.readBool();
+      StratAndMetadata s = StratAndMetadata::makeCrossover();
+      if (!isCrossover) {
+        // Start with a default strategy so the number of decisions matches.
+        s = StratAndMetadata(Strategy::makeMutateStrategies().front());
+        if (auto err = s.strat.deserialize(r.readString()))
+          r.fail(err->getMessage());
+      } else {
+        r.readString();
+      }
+      s.stats.load(r);
+      // Crossover follows the current setting instead of the checkpoint.
+      if (!isCrossover || crossover)
+        loaded.push_back(s);
+    }
+    if (crossover && std::none_of(loaded.begin(), loaded.end(),
+                                  [](const StratAndMetadata &s) {
+                                    return s.isCrossover;
+                                  }))
+      loaded.push_back(StratAndMetadata::makeCrossover());
+
+    std::vector<UnreducedFinding> unreduced;
+    const size_t numUnreduced = r.readSize();
+    for (size_t i = 0; i < numUnreduced && !r.hasFailed(); ++i) {
+      Maybe<Program> p = ProgramSerializer::read(r);
+      if (p.isErr()) {
+        r.fail(p.getErrorMsg());
+        break;
+      }
+      unreduced.push_back({std::move(*p), r.readString()});
+    }
 
-  const Program &getBestProg() override {
-    if (reducer)
-      return reducer->getProgram();
-    SCCAssert(!queue.empty(), "No best program available?");
-    return queue.back().p;
+    if (!r.hasFailed() && !r.atEnd())
+      r.fail("Trailing data");
+    if (r.hasFailed())
+      return Err("Malformed checkpoint " + Checkpoint::getPath(dir) + ": " +
+                 r.getError());
+    if (!loaded.empty())
+      strategies = loaded;
+    lastStrat = nullptr;
+
+    for (const UnreducedFinding &f : unreduced)
+      startReduction(f.p, f.signature);
+    return {};
   }
 
-  std::string getBestProcMsg() const override {
-    if (queue.empty())
-      return "";
-    return queue.back().message;
+  std::optional<ClusterJob> makeClusterJob() override {
+    collectBackgroundReductions();
+    // Foreground reductions are stepped by `step`.
+    if (fuzzingFinished() || reducer)
+      return std::nullopt;
+    maybeWriteCheckpoint();
+    ++iterations;
+
+    ProgAndMetadata base = pickMutationBase();
+    // Crossover needs a second queue entry, which workers don't have.
+    StratAndMetadata *strat = &pickStrat();
+    while (strat->isCrossover)
+      strat = &pickStrat();
+
+    ClusterJob job;
+    job.id = nextClusterJobId++;
+    job.parent = base.lineage ? *getEntryProgram(base) : base.p;
+    job.parentHash = base.hash;
+    job.seed = getRandomSeed();
+    job.strategy = strat->strat.serialize();
+    job.scale = std::max<unsigned>(1U, rng.getBelow(mutatorScale));
+    PendingClusterJob &pending = clusterJobs[job.id];
+    pending.base = std::move(base);
+    pending.strategyId = getStrategyId(*strat);
+    return job;
   }
 
-  Strategy *getLastStrat() const { return lastStrat; }
+  void applyClusterResult(ClusterResult &res) override {
+    auto pending = clusterJobs.find(res.jobId);
+    if (pending == clusterJobs.end())
+      return;
+    const ProgAndMetadata base = std::move(pending->second.base);
+    // The result is not credited to any strategy if the used strategy was
+    // replaced in the meantime.
+    StratAndMetadata *strat = findStrategy(pending->second.strategyId);
+    clusterJobs.erase(pending);
+
+    if (strat)
+      strat->stats.mutateMicros += res.mutateMicros;
+    // Another worker might have evaluated the same mutant.
+    if (res.rejected || cache.isInCache(res.hash)) {
+      markFruitless(base.id);
+      rejectStrat(strat);
+      return;
+    }
+    nonCacheIterations++;
+    if (strat)
+      strat->stats.oracleMicros += res.oracleMicros;
+
+    std::vector<typename Strategy::Frag> taken;
+    for (uint64_t decision : res.taken)
+      taken.push_back(static_cast<typename Strategy::Frag>(decision));
+    auto learn = [&](bool success) {
+      if (strat && decisionLearningRate > 0)
+        strat->strat.reinforce(taken, success, decisionLearningRate);
+    };
+    // The worker's dictionary might differ, so the mutation can't be
+    // replayed here.
+    handleFeedback(strat, base, res.mutant, res.hash, res.feedback, learn,
+                   MutationRecipe());
+  }
 
-  GeneratorT &getGenerator() { return gen; }
+  void dropClusterJob(uint64_t jobId) override { clusterJobs.erase(jobId); }
+
+  ClusterResult runClusterJob(const ClusterJob &job) override {
+    ClusterResult res;
+    res.jobId = job.id;
+    Stopwatch timer;
+    // Start with a default strategy so the number of decisions matches.
+    Strategy strat = Strategy::makeMutateStrategies().front();
+    if (strat.deserialize(job.strategy)) {
+      res.rejected = true;
+      return res;
+    }
+    Program p = job.parent;
+    for (auto decision :
+         mutateWith(p, job.seed, strat, job.scale, dictionary))
+      res.taken.push_back(static_cast<uint64_t>(decision));
+
+    const ProgramCache::Digest digest = ProgramCache::digest(p);
+    res.rejected = !digest.printable;
+    if (!res.rejected) {
+      const CandidateFilter::Candidate candidate{p, digest, job.parentHash};
+      res.rejected = filters.rejects(candidate) || cache.isInCache(digest.hash);
+    }
+    res.mutateMicros = timer.lap();
+    if (res.rejected)
+      return res;
+
+    res.feedback = evaluate(p, digest);
+    res.oracleMicros = timer.lap();
+    res.hash = digest.hash;
+    res.mutant = std::move(p);
+    return res;
+  }
 };
 
 #endif // SCHEDULER_H
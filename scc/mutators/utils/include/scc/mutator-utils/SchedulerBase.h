@@ -1,12 +1,28 @@
 #ifndef SCHEDULERBASE_H
 #define SCHEDULERBASE_H
 
+#include <algorithm>
 #include <functional>
 #include <list>
-
+#include <memory>
+#include <optional>
+
+#include "CandidateFilter.h"
+#include "Checkpoint.h"
+#include "ConstantDictionary.h"
+#include "CorpusSync.h"
+#include "FeatureMap.h"
+#include "PowerSchedule.h"
 #include "ProgramCache.h"
+#include "ProgramLineage.h"
+#include "ProgramSketch.h"
+#include "ResultStore.h"
 #include "Rng.h"
+#include "SignatureIndex.h"
+#include "StrategyStats.h"
+#include "SurrogateModel.h"
 #include "scc/program/Program.h"
+#include "scc/utils/ThreadPool.h"
 
 /// Base class for the scheduler.
 ///
@@ -20,10 +36,97 @@ public:
     bool interesting = false;
     bool deadEnd = false;
     std::string msg;
+    /// Identifies the bug behind an interesting program (empty if the oracle
+    /// didn't report one).
+    std::string signature;
+    /// Constants suggested by the oracle in the '<type>:<value>' format.
+    std::vector<std::string> dictionary;
+    /// The coverage features the program hit (see `FeatureMap`).
+    std::vector<uint32_t> features;
   };
   typedef std::function<Feedback(const Program &)> FeedbackFunc;
 
+  /// An interesting program that wasn't reduced yet.
+  struct UnreducedFinding {
+    Program p;
+    /// The bug signature the reduced program has to keep.
+    std::string signature;
+  };
+
+  /// A mutation that a cluster worker runs for the coordinator (see
+  /// `ClusterCoordinator`).
+  struct ClusterJob {
+    uint64_t id = 0;
+    /// The program to mutate.
+    Program parent;
+    HashStream::Hash parentHash = 0;
+    uint64_t seed = 0;
+    /// The serialized mutation strategy.
+    std::string strategy;
+    unsigned scale = 1;
+
+    void save(BinaryWriter &w) const;
+    void load(BinaryReader &r);
+  };
+
+  /// What a cluster worker reports back for a `ClusterJob`.
+  struct ClusterResult {
+    uint64_t jobId = 0;
+    /// Whether the mutant was thrown away before reaching the oracle. The
+    /// other members are only set if this is false.
+    bool rejected = false;
+    Program mutant;
+    HashStream::Hash hash = 0;
+    Feedback feedback;
+    /// The decisions taken during the mutation.
+    std::vector<uint64_t> taken;
+    uint64_t mutateMicros = 0;
+    uint64_t oracleMicros = 0;
+
+    void save(BinaryWriter &w) const;
+    void load(BinaryReader &r);
+  };
+
+  /// Wraps the feedback function so that programs only count as interesting
+  /// if they have the given bug signature. Returns `f` if the signature is
+  /// empty.
+  static FeedbackFunc requireSignature(FeedbackFunc f,
+                                       const std::string &signature) {
+    if (signature.empty())
+      return f;
+    return [f, signature](const Program &p) {
+      Feedback res = f(p);
+      res.interesting = res.interesting && res.signature == signature;
+      return res;
+    };
+  }
+
 protected:
+  /// Returns the stored feedback of the program or calls `f` and stores its
+  /// feedback. `digest` has to be the digest of the printable program `p`.
+  static Feedback evaluateWithStore(const FeedbackFunc &f, ResultStore &store,
+                                    const Program &p,
+                                    const ProgramCache::Digest &digest) {
+    if (std::optional<ResultStore::Result> stored =
+            store.lookup(digest.contentHash, digest.size)) {
+      Feedback res(stored->score);
+      res.interesting = stored->interesting;
+      res.deadEnd = stored->deadEnd;
+      res.msg = stored->msg;
+      res.signature = stored->signature;
+      return res;
+    }
+    Feedback res = f(p);
+    ResultStore::Result r;
+    r.score = res.score;
+    r.interesting = res.interesting;
+    r.deadEnd = res.deadEnd;
+    r.msg = res.msg;
+    r.signature = res.signature;
+    store.store(digest.contentHash, digest.size, r);
+    return res;
+  }
+
   /// The fitness function (the function to call on a program to give it a
   /// score).
   FeedbackFunc evalFunc;
@@ -33,7 +136,10 @@ protected:
 
   /// Groups a program and the scheduling metadata.
   struct ProgAndMetadata {
+    /// The program. Empty in compact queue mode.
     Program p;
+    /// How to rebuild the program. Only set in compact queue mode.
+    ProgramLineage::Ref lineage;
     size_t programNodes = 0;
     size_t lengthGranularity = 1;
     std::string feedbackMsg;
@@ -51,13 +157,33 @@ protected:
     Score score = std::numeric_limits<Score>::min();
     /// How often we selected it as the base for mutations.
     size_t runs = 0;
+    /// Unique id of this entry in the queue.
+    size_t id = 0;
+    /// The number of non-cached iterations when this entry was queued.
+    size_t queuedAt = 0;
+    /// How often the power schedule picked this entry.
+    size_t picks = 0;
+    /// How many mutations of this entry did not lead to any progress.
+    size_t fruitlessRuns = 0;
     /// The message from the oracle for this one.
     std::string message;
+    /// How many coverage features the program hit.
+    size_t features = 0;
+    /// The hash of the printed program (or 0 if unknown).
+    HashStream::Hash hash = 0;
+    /// The structure of the program. Only computed if the queue diversity
+    /// is controlled.
+    ProgramSketch sketch;
+    /// How many other queue entries are similar to this one (see
+    /// `sortQueue`).
+    size_t similarEntries = 0;
   };
 
   /// The queue of candidates to mutate. Back of the queue
   /// is always the program with the highest score.
   std::list<ProgAndMetadata> queue;
+  /// Incremented whenever an entry is added to the queue.
+  size_t queueChanges = 0;
 
   unsigned desperation = 1;
   void setDesperation(size_t i) {
@@ -67,8 +193,18 @@ protected:
   }
 
   /// The maximum amount of times a proram can serve as a
-  /// candidate for mutation.
+  /// candidate for mutation. With a power schedule other than
+  /// `PowerSchedule::Fixed`, this is the maximum energy of a single pick.
   size_t maxRunLimit = 100;
+
+  /// How mutations are distributed over the queue.
+  PowerSchedule powerSchedule = PowerSchedule::Fixed;
+  /// The id of the entry that is currently mutated by the power schedule.
+  size_t currentEntryId = 0;
+  /// How many mutations are left for the current entry.
+  size_t energyLeft = 0;
+  /// The id that is assigned to the next queued entry.
+  size_t nextEntryId = 1;
   /// How many programs to keep in the queue.
   size_t maxQueueSize = 300;
 
@@ -77,6 +213,9 @@ protected:
 
   std::vector<Program> interestingResults;
 
+  /// Errors that didn't stop fuzzing and that weren't reported yet.
+  std::vector<std::string> errors;
+
   size_t numFindings = 0;
 
   unsigned mutatorScale = 1;
@@ -85,22 +224,310 @@ protected:
 
   unsigned reducerTries = 4000;
 
+  /// After how many non-cached iterations the strategies are evolved. 0
+  /// disables the evolution of strategies.
+  size_t evolveEvery = 0;
+  /// The maximum number of strategies that can exist at the same time.
+  size_t maxStrategies = 32;
+  /// How many of the best strategies are never replaced.
+  size_t eliteStrategies = 3;
+  /// How many times a strategy has to be used before it can be replaced.
+  size_t minStrategyRuns = 200;
+  /// How strongly the decisions taken during a mutation are rewarded or
+  /// punished depending on whether the mutation was successful. 0 disables
+  /// learning decision chances.
+  float decisionLearningRate = 0.02f;
+  /// How many reduction candidates are evaluated in parallel.
+  unsigned reducerThreads = 1;
+  /// The threads used by the reducer. Kept alive between reductions.
+  std::shared_ptr<ThreadPool> reducerPool;
+
+  /// How many findings are reduced at once in the background. 0 reduces
+  /// findings in `step` which pauses fuzzing until the reduction is done.
+  size_t backgroundReductions = 0;
+  /// The fraction of time each background reduction may use.
+  double reductionCPUShare = 1.0;
+
+  /// Whether crossover between queue entries is scheduled like a mutation
+  /// strategy.
+  bool crossover = false;
+
+  /// How many mutants are created ahead of time on a separate thread while
+  /// the oracle runs. 0 mutates in `step`.
+  size_t pipelineDepth = 0;
+  /// How many mutants created ahead of time were thrown away because the
+  /// queue changed before they were evaluated.
+  size_t discardedMutants = 0;
+
+  /// How many better queue entries an entry may be similar to before it is
+  /// removed from the queue. 0 disables the diversity control.
+  size_t maxSimilarEntries = 0;
+  /// From which similarity on two queue entries count as similar (0 to 1).
+  double similarityThreshold = 0.9;
+  /// How many queue entries were removed because they were too similar to
+  /// better entries.
+  size_t similarEvictions = 0;
+
+  /// Computes the sketch of the given entry if the diversity is controlled.
+  void updateSketch(ProgAndMetadata &e, const Program &p) {
+    if (maxSimilarEntries != 0)
+      e.sketch = ProgramSketch::compute(p);
+  }
+
+  /// Counts how many other queue entries are similar to each entry.
+  void countSimilarEntries();
+  /// Removes entries that have `maxSimilarEntries` similar entries that
+  /// are better. Expects a sorted queue.
+  void evictSimilarEntries();
+
+  /// Whether queue entries only store their lineage instead of the full
+  /// program.
+  bool compactQueue = false;
+  /// After how many replayed mutations a full program is stored again in
+  /// compact queue mode.
+  size_t maxReplayDepth = 8;
+  /// Recently used programs in compact queue mode.
+  MaterializedPrograms materialized;
+  /// Keeps the program returned by `getBestProg` alive in compact queue mode.
+  std::shared_ptr<const Program> pinnedBestProg;
+
+  /// Findings grouped by their bug signature.
+  SignatureIndex signatures;
+
+  /// Oracle results of previous runs (or null if results aren't persisted).
+  std::shared_ptr<ResultStore> resultStore;
+
+  /// Evaluates the printable program with the given digest, consulting the
+  /// result store first.
+  Feedback evaluate(const Program &p, const ProgramCache::Digest &digest) {
+    if (!resultStore)
+      return evalFunc(p);
+    return evaluateWithStore(evalFunc, *resultStore, p, digest);
+  }
+
+  /// Returns the fitness function wrapped so that it consults the result
+  /// store first.
+  FeedbackFunc getEvalFunc() const {
+    if (!resultStore)
+      return evalFunc;
+    return [f = evalFunc, store = resultStore](const Program &p) {
+      const ProgramCache::Digest digest = ProgramCache::digest(p);
+      if (!digest.printable)
+        return f(p);
+      return evaluateWithStore(f, *store, p, digest);
+    };
+  }
+
+  /// Rejects mutated programs before they are sent to the oracle.
+  CandidateFilter filters;
+
+  /// Adds the filters that are always enabled.
+  void addDefaultFilters() {
+    filters.add("unchanged", CandidateFilter::unchangedFromParent());
+    filters.add("forbidden", CandidateFilter::forbiddenConstructs());
+  }
+
+  /// Predicts which candidates are worth running the oracle on (or null if
+  /// all candidates are evaluated).
+  std::unique_ptr<SurrogateModel> surrogate;
+
+  /// All coverage features the oracle reported so far.
+  FeatureMap features;
+  /// How many programs were queued only because they hit new features.
+  size_t novelPrograms = 0;
+
+  /// Constants suggested by the oracle. The dictionary is replaced instead of
+  /// modified, so mutations can later be replayed with the dictionary they
+  /// originally used.
+  std::shared_ptr<const ConstantDictionary> dictionary =
+      std::make_shared<ConstantDictionary>();
+  /// The maximum number of constants in the dictionary.
+  size_t dictionaryCapacity = 256;
+
+  /// Adds the constants suggested in the feedback to the dictionary.
+  void updateDictionary(const Feedback &f) {
+    if (f.dictionary.empty())
+      return;
+    auto updated = std::make_shared<ConstantDictionary>(*dictionary);
+    updated->setCapacity(dictionaryCapacity);
+    for (const std::string &entry : f.dictionary)
+      updated->addFromOracle(entry);
+    dictionary = updated;
+  }
+
+  /// The file that evolved strategies are stored in (or empty if the
+  /// strategies shouldn't be stored).
+  std::string strategyFile;
+
+  /// The directory checkpoints are written to (or empty if checkpoints are
+  /// disabled).
+  std::string checkpointDir;
+  /// After how many non-cached iterations a checkpoint is written. 0 only
+  /// writes a checkpoint when `writeCheckpoint` is called.
+  size_t checkpointEvery = 0;
+  /// The number of non-cached iterations when the last checkpoint was
+  /// written.
+  size_t lastCheckpoint = 0;
+
+  /// Programs from the seed corpus that weren't evaluated yet.
+  std::vector<Program> pendingSeeds;
+  /// The evaluated seeds. If there are any, queue resets start from them
+  /// instead of generated programs.
+  std::vector<ProgAndMetadata> seeds;
+
+  /// Evaluates the pending seeds. Seeds that are already interesting or a
+  /// dead end are dropped.
+  void evaluateSeeds();
+  /// Adds up to `n` random seeds to the queue. Returns false if there are no
+  /// seeds.
+  bool addSeeds(size_t n);
+
+  /// Exchanges queue entries with other instances (or null if syncing is
+  /// disabled).
+  std::unique_ptr<CorpusSync> corpusSync;
+  /// After how many non-cached iterations the corpus is synced.
+  size_t syncEvery = 0;
+  /// How many programs are imported at most per sync.
+  size_t syncImportBudget = 0;
+  /// The number of non-cached iterations at the last sync.
+  size_t lastSync = 0;
+  /// The best score that was exported so far.
+  Score lastExportedScore = std::numeric_limits<Score>::min();
+
+  /// Exports the best queue entry if it improved since the last sync and
+  /// merges the programs of other instances into the queue.
+  void maybeSyncCorpus();
+
+  /// Writes the state that all schedulers share for a checkpoint. Settings
+  /// are not stored as they come from the command line.
+  void saveBaseState(BinaryWriter &w);
+  /// Restores the state written by `saveBaseState`.
+  void loadBaseState(BinaryReader &r);
+
+  /// Writes a checkpoint if enough iterations passed since the last one.
+  /// A failed checkpoint is reported and retried after the next interval.
+  void maybeWriteCheckpoint() {
+    if (checkpointEvery == 0 || checkpointDir.empty())
+      return;
+    if (nonCacheIterations - lastCheckpoint < checkpointEvery)
+      return;
+    if (OptError err = writeCheckpoint())
+      addError("Failed to write checkpoint: " + err->getMessage());
+  }
+
 protected:
-  void addProgram(Program &&p) {
-    ProgAndMetadata start;
-    start.setProgram(std::move(p));
-    queue.push_back(ProgAndMetadata(start));
+  /// Adds the given entry to the queue (without sorting it).
+  void enqueue(ProgAndMetadata &&e) {
+    e.id = nextEntryId++;
+    e.queuedAt = nonCacheIterations;
+    queue.push_back(std::move(e));
+    ++queueChanges;
+  }
+
+  /// Creates a queue entry for the given program.
+  ProgAndMetadata makeEntry(Program &&p) {
+    ProgAndMetadata res;
+    res.hash = ProgramCache::digest(p).hash;
+    updateSketch(res, p);
+    if (compactQueue) {
+      res.programNodes = p.countNodes();
+      res.lineage = ProgramLineage::makeKeyframe(p);
+    } else {
+      res.setProgram(std::move(p));
+    }
+    return res;
+  }
+
+  void addProgram(Program &&p) { enqueue(makeEntry(std::move(p))); }
+
+  /// Returns the program of the given queue entry.
+  std::shared_ptr<const Program> getEntryProgram(const ProgAndMetadata &e) {
+    if (!e.lineage)
+      return std::make_shared<const Program>(e.p);
+    return materialized.get(e.lineage);
+  }
+
+  /// Returns the queue entry with the given id or queue.end().
+  std::list<ProgAndMetadata>::iterator findQueueEntry(size_t id) {
+    return std::find_if(queue.begin(), queue.end(),
+                        [id](const ProgAndMetadata &e) { return e.id == id; });
+  }
+
+  /// Collects the stats the power schedule needs for the given entry.
+  QueueEntryStats getEntryStats(std::list<ProgAndMetadata>::iterator entry) {
+    QueueEntryStats res;
+    res.queueSize = queue.size();
+    res.rank = std::distance(entry, queue.end()) - 1;
+    res.nodes = entry->programNodes;
+    res.age = nonCacheIterations - entry->queuedAt;
+    res.picks = entry->picks;
+    res.fruitlessRuns = entry->fruitlessRuns;
+    res.features = entry->features;
+    for (const ProgAndMetadata &e : queue) {
+      res.averageNodes += e.programNodes;
+      res.averageAge += nonCacheIterations - e.queuedAt;
+      res.averageFruitlessRuns += e.fruitlessRuns;
+      res.averageFeatures += e.features;
+    }
+    res.averageNodes /= queue.size();
+    res.averageAge /= queue.size();
+    res.averageFruitlessRuns /= queue.size();
+    res.averageFeatures /= queue.size();
+    return res;
+  }
+
+  /// Returns the queue entry that should be mutated next.
+  ProgAndMetadata &pickQueueEntry() {
+    SCCAssert(!queue.empty(), "Picking from empty queue?");
+    auto current = findQueueEntry(currentEntryId);
+    if (powerSchedule == PowerSchedule::Fixed) {
+      current = std::prev(queue.end());
+    } else if (current == queue.end() || energyLeft == 0) {
+      // Walk from the best to the worst entry and then start again at the
+      // best. Entries without any energy are skipped.
+      for (size_t i = 0; i < queue.size(); ++i) {
+        if (current == queue.end() || current == queue.begin())
+          current = std::prev(queue.end());
+        else
+          current = std::prev(current);
+        energyLeft =
+            computeEnergy(powerSchedule, getEntryStats(current), maxRunLimit);
+        current->picks += 1;
+        if (energyLeft != 0)
+          break;
+      }
+      energyLeft = std::max<size_t>(energyLeft, 1);
+    }
+    currentEntryId = current->id;
+    if (energyLeft > 0)
+      --energyLeft;
+    return *current;
+  }
+
+  /// Records that a mutation of the given entry did not lead anywhere.
+  void markFruitless(size_t id) {
+    auto entry = findQueueEntry(id);
+    if (entry != queue.end())
+      entry->fruitlessRuns += 1;
   }
 
   void sortQueue() {
     for (ProgAndMetadata &p : queue)
       p.lengthGranularity = desperation;
+    if (maxSimilarEntries != 0)
+      countSimilarEntries();
 
     queue.sort([](const ProgAndMetadata &l, const ProgAndMetadata &r) {
-      if (l.score == r.score)
+      if (l.score == r.score) {
+        // Prefer mutating entries that are unlike the rest of the queue.
+        if (l.similarEntries != r.similarEntries)
+          return l.similarEntries > r.similarEntries;
         return l.sizeForSorting() > r.sizeForSorting();
+      }
       return l.score < r.score;
     });
+    if (maxSimilarEntries != 0)
+      evictSimilarEntries();
     while (queue.size() > maxQueueSize)
       queue.pop_front();
   }
@@ -119,53 +546,142 @@ protected:
   ProgramCache cache;
 
   void informAboutRun(bool madeProgress) {
+    const bool fixed = powerSchedule == PowerSchedule::Fixed;
     if (madeProgress) {
-      mutatorScale = 1;
       runsSinceProgress = 0;
-      setDesperation(1);
+      if (fixed) {
+        mutatorScale = 1;
+        setDesperation(1);
+      }
       return;
     }
-    mutatorScale = 1;
     ++runsSinceProgress;
-    if (runsSinceProgress > 20000)
-      setDesperation(32);
-    if (runsSinceProgress > 40000)
-      setDesperation(64);
-    if (runsSinceProgress > 80000) {
-      setDesperation(128);
-      mutatorScale = 2;
-    }
-    if (runsSinceProgress > 180000) {
-      mutatorScale = 3;
-    }
-    if (runsSinceProgress > 300000) {
-      setDesperation(256);
-      mutatorScale = 3;
+    // The other schedules deal with plateaus by moving energy around.
+    if (!fixed)
+      return;
+    mutatorScale = 1;
+    for (const PlateauLevel &level : fixedPlateauLadder) {
+      if (runsSinceProgress <= level.runsWithoutProgress)
+        break;
+      setDesperation(level.desperation);
+      mutatorScale = level.mutatorScale;
     }
   }
 
 public:
   /// Creates a scheduler that mutates a new program.
   SchedulerBase(FeedbackFunc feedback, uint64_t seed)
-      : evalFunc(feedback), rng(RngSource(seed)) {}
+      : evalFunc(feedback), rng(RngSource(seed)) {
+    addDefaultFilters();
+  }
 
   /// Creates a scheduler that mutates a new program.
   /// The created Scheduler here is dead, it needs a
   /// feedback function supplied before the first run.
-  SchedulerBase(uint64_t seed) : rng(RngSource(seed)) {}
+  SchedulerBase(uint64_t seed) : rng(RngSource(seed)) { addDefaultFilters(); }
 
   Score getBestScore() const { return queue.back().score; }
 
   void setEvalFunction(FeedbackFunc f) { evalFunc = f; }
 
+  /// Returns the function set by `setEvalFunction`.
+  const FeedbackFunc &getEvalFunction() const { return evalFunc; }
+
   size_t getNumFindings() const { return numFindings; }
 
+  /// Adds a finding that was found and reduced elsewhere, e.g. by another
+  /// island of an `IslandScheduler`.
+  void addFinding(Program p) {
+    numFindings += 1;
+    interestingResults.push_back(std::move(p));
+  }
+
+  /// Returns copies of the best `n` programs in the queue.
+  std::vector<Program> getBestPrograms(size_t n);
+
+  /// Evaluates the given programs from another scheduler with this
+  /// scheduler's oracle and adds them to the queue. Findings and dead ends
+  /// are dropped as they are reported by the scheduler that found them.
+  void importPrograms(std::vector<Program> programs);
+
+  /// Returns how many findings were not reduced because a finding with the
+  /// same bug signature was already reduced.
+  size_t getDuplicateFindings() const { return signatures.getDuplicates(); }
+
+  /// Returns the number of distinct bug signatures found so far.
+  size_t getNumSignatures() const { return signatures.getNumSignatures(); }
+
+  /// Sets how many findings per bug signature are reduced.
+  void setReductionsPerSignature(size_t n) {
+    signatures.setReductionsPerSignature(n);
+  }
+
+  /// Appends a filter that rejects mutated programs before they are sent to
+  /// the oracle. Rejections count as a run without gain for the strategy.
+  void addCandidateFilter(std::string name, CandidateFilter::RejectFunc f) {
+    filters.add(name, f);
+  }
+
+  const CandidateFilter &getCandidateFilter() const { return filters; }
+
+  /// Skips the given fraction of candidates that a learned model predicts to
+  /// be the least useful. `exploration` is the fraction of those that is
+  /// evaluated anyway. A fraction of 0 disables the model.
+  void setSurrogate(double skipFraction, double exploration) {
+    if (skipFraction <= 0) {
+      surrogate.reset();
+      return;
+    }
+    surrogate = std::make_unique<SurrogateModel>();
+    surrogate->setSkipFraction(skipFraction);
+    surrogate->setExplorationRate(exploration);
+  }
+
+  /// Persists oracle results in the given file and reuses the results that
+  /// are already stored there (see `ResultStore`).
+  OptError setResultStore(const std::string &path, size_t maxBytes) {
+    auto store = ResultStore::open(path, maxBytes);
+    if (store.isErr())
+      return store.takeError();
+    resultStore = std::move(*store);
+    return {};
+  }
+
+  /// Returns the result store or null if results aren't persisted.
+  const ResultStore *getResultStore() const { return resultStore.get(); }
+
+  /// Returns the surrogate model or null if it's disabled.
+  const SurrogateModel *getSurrogate() const { return surrogate.get(); }
+
+  /// Returns the number of distinct coverage features seen so far.
+  size_t getNumFeatures() const { return features.getNumFeatures(); }
+
+  /// Returns how many programs were queued because they hit new coverage
+  /// features without improving the score.
+  size_t getNovelPrograms() const { return novelPrograms; }
+
+  /// Sets how many constants suggested by the oracle are remembered.
+  void setDictionaryCapacity(size_t n) { dictionaryCapacity = n; }
+
+  /// Returns the number of constants the oracle suggested so far.
+  size_t getDictionarySize() const { return dictionary->size(); }
+
   std::vector<Program> popInteresting() {
     auto res = interestingResults;
     interestingResults.clear();
     return res;
   }
 
+  /// Adds an error that doesn't stop fuzzing, e.g., of another island.
+  void addError(std::string msg) { errors.push_back(std::move(msg)); }
+
+  /// Returns the errors that were added since the last call.
+  std::vector<std::string> popErrors() {
+    std::vector<std::string> res = std::move(errors);
+    errors.clear();
+    return res;
+  }
+
   size_t getDesperation() const { return desperation; }
 
   void requestQueueReset() { resetRequest = true; }
@@ -179,23 +695,177 @@ public:
 
   virtual bool isReducing() const { return false; }
 
+  /// Returns the gain/cost statistics of every mutation strategy.
+  virtual std::vector<NamedStrategyStats> getStrategyStats() const {
+    return {};
+  }
+
   std::string getLastStratInfo() const { return lastStratInfo; }
 
   void setMaxRunLimit(size_t v) { maxRunLimit = v; }
 
+  /// Enables storing queue entries as replayable mutations instead of full
+  /// programs. This has to be set before the first step.
+  void setCompactQueue(bool v) { compactQueue = v; }
+
+  /// Sets how many rebuilt programs are cached in compact queue mode.
+  void setMaterializedPrograms(size_t v) { materialized.setCapacity(v); }
+
+  /// Returns how many mutations were replayed to rebuild queue entries.
+  size_t getReplayedMutations() const { return materialized.getReplays(); }
+
+  void setPowerSchedule(PowerSchedule s) {
+    powerSchedule = s;
+    energyLeft = 0;
+  }
+
+  PowerSchedule getPowerSchedule() const { return powerSchedule; }
+
   void setMaxQueueSize(size_t v) { maxQueueSize = v; }
 
   void setMutatorScale(unsigned v) { mutatorScale = v; }
 
   void setReducerTries(unsigned i) { reducerTries = i; }
 
-  bool finished() const {
+  /// Reduces up to the given number of findings in the background while
+  /// fuzzing continues. The feedback function has to be thread-safe if this
+  /// is not 0. `share` is the fraction of time each reduction may use.
+  void setBackgroundReductions(size_t concurrency, double share) {
+    backgroundReductions = concurrency;
+    reductionCPUShare = share;
+  }
+
+  /// Sets how many reduction candidates are evaluated concurrently. The
+  /// feedback function has to be thread-safe if this is more than 1.
+  void setReducerThreads(unsigned i) {
+    reducerThreads = std::max(1U, i);
+    reducerPool.reset();
+    if (reducerThreads > 1)
+      reducerPool = std::make_shared<ThreadPool>(reducerThreads);
+  }
+
+  /// Creates up to the given number of mutants ahead of time on a separate
+  /// thread, so that mutating and printing overlaps with the oracle. 0
+  /// disables the pipeline.
+  void setPipelineDepth(size_t v) { pipelineDepth = v; }
+
+  size_t getDiscardedMutants() const { return discardedMutants; }
+
+  /// Removes queue entries that are similar to `maxSimilar` better entries.
+  /// Two entries are similar if the estimated similarity of their structure
+  /// is at least `threshold` (0 to 1). Among entries with the same score,
+  /// those with fewer similar entries are mutated first. 0 disables the
+  /// limit.
+  void setDiversity(size_t maxSimilar, double threshold) {
+    maxSimilarEntries = maxSimilar;
+    similarityThreshold = threshold;
+  }
+
+  size_t getMaxSimilarEntries() const { return maxSimilarEntries; }
+
+  size_t getSimilarEvictions() const { return similarEvictions; }
+
+  void setEvolveEvery(size_t v) { evolveEvery = v; }
+
+  void setMaxStrategies(size_t v) { maxStrategies = v; }
+
+  void setMinStrategyRuns(size_t v) { minStrategyRuns = v; }
+
+  void setDecisionLearningRate(float v) { decisionLearningRate = v; }
+
+  /// Enables transplanting functions, globals and statements between queue
+  /// entries as an additional mutation strategy.
+  virtual void setCrossover(bool v) { crossover = v; }
+
+  /// Sets the file that evolved strategies are persisted to.
+  ///
+  /// If the file already exists, the strategies are loaded from it.
+  virtual OptError setStrategyFile(std::string path) {
+    strategyFile = path;
+    return {};
+  }
+
+  /// Starts fuzzing from the programs in the given directory (see
+  /// `SeedCorpus`) instead of generated programs. The seeds are evaluated
+  /// before the first mutation, on the reducer threads if there are any.
+  OptError loadSeedCorpus(const std::string &dir, size_t maxSeeds);
+
+  /// Returns the number of seeds that queue resets can start from.
+  size_t getNumSeeds() const { return pendingSeeds.size() + seeds.size(); }
+
+  /// Exchanges queue entries with other instances through the given
+  /// directory (see `CorpusSync`) every `every` non-cached iterations. At
+  /// most `importBudget` programs of other instances are imported per sync.
+  /// They are evaluated with this scheduler's fitness function.
+  OptError setCorpusSync(const std::string &dir, const std::string &name,
+                         bool primary, size_t every, size_t importBudget);
+
+  /// Returns the corpus sync or null if syncing is disabled.
+  const CorpusSync *getCorpusSync() const { return corpusSync.get(); }
+
+  /// Writes a checkpoint to the given directory every `every` non-cached
+  /// iterations.
+  void setCheckpointDir(std::string dir, size_t every) {
+    checkpointDir = dir;
+    checkpointEvery = every;
+  }
+
+  /// Writes the current state to the checkpoint directory. Does nothing if
+  /// checkpoints are disabled.
+  virtual OptError writeCheckpoint() { return {}; }
+
+  /// Restores the state from the checkpoint in the given directory. Has to
+  /// be called after the scheduler is configured and before the first step.
+  virtual OptError resumeFrom(const std::string &dir) {
+    return Err("Scheduler doesn't support checkpoints");
+  }
+
+  /// Picks the next mutation for a cluster worker and remembers it until
+  /// its result arrives. Returns nothing if no mutation should be started
+  /// right now, e.g. because a finding is reduced in the foreground.
+  virtual std::optional<ClusterJob> makeClusterJob() { return std::nullopt; }
+
+  /// Updates the queue and the strategies with the result of a job from
+  /// `makeClusterJob`.
+  virtual void applyClusterResult(ClusterResult &res) {}
+
+  /// Forgets a job whose worker was lost.
+  virtual void dropClusterJob(uint64_t jobId) {}
+
+  /// Runs the mutation of the given job and evaluates the mutant. Called
+  /// by cluster workers.
+  virtual ClusterResult runClusterJob(const ClusterJob &job) {
+    SCCError("Scheduler doesn't support cluster mode");
+  }
+
+  /// Returns the constants that mutations can use.
+  std::shared_ptr<const ConstantDictionary> getDictionary() const {
+    return dictionary;
+  }
+
+  /// Replaces the constants that mutations can use. Used by cluster workers
+  /// to get the dictionary of the coordinator.
+  void setDictionary(std::shared_ptr<const ConstantDictionary> d) {
+    dictionary = std::move(d);
+  }
+
+  /// Returns true if no more mutations should be done.
+  bool fuzzingFinished() const {
     // If we're supposed to stop after a certain amount of findings then stop.
     if (stopAfterHits != 0 && numFindings >= stopAfterHits)
       return true;
     return nonCacheIterations >= stopAfterNIterations;
   }
 
+  /// Returns the number of findings that are still being reduced in the
+  /// background.
+  virtual size_t getUnfinishedReductions() const { return 0; }
+
+  /// Returns true if fuzzing is done and all findings were reduced.
+  bool finished() const {
+    return fuzzingFinished() && getUnfinishedReductions() == 0;
+  }
+
   void setStopAfter(size_t v) { stopAfterNIterations = v; }
 
   void setStopAfterHit(std::size_t v) { stopAfterHits = v; }
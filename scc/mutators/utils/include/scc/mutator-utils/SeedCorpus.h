@@ -0,0 +1,27 @@
+#ifndef SEEDCORPUS_H
+#define SEEDCORPUS_H
+
+#include "scc/program/Program.h"
+#include "scc/utils/Maybe.h"
+
+#include <string>
+#include <vector>
+
+/// Loads programs that previous runs saved as '.scc' files (see
+/// `ProgramSerializer::save`), so a new run can start from them instead of
+/// from generated programs.
+class SeedCorpus {
+public:
+  /// The file extension of saved programs.
+  static constexpr const char *extension = ".scc";
+
+  /// Loads the programs in the given directory.
+  ///
+  /// Programs that print the same are only loaded once. If there are more
+  /// than `maxSeeds` programs, the smallest ones are kept as they are the
+  /// cheapest to mutate. Files that can't be read are skipped.
+  static Maybe<std::vector<Program>> load(const std::string &dir,
+                                          size_t maxSeeds);
+};
+
+#endif // SEEDCORPUS_H
@@ -0,0 +1,55 @@
+#ifndef SIGNATUREINDEX_H
+#define SIGNATUREINDEX_H
+
+#include <cstddef>
+#include <map>
+#include <string>
+
+#include "scc/utils/BinaryStream.h"
+
+/// Groups findings by the bug signature the oracle reported for them.
+///
+/// Used to avoid reducing the same bug over and over again. Only the first
+/// few hits of every signature are reduced, as well as hits that are smaller
+/// than any hit of that signature that was reduced so far.
+class SignatureIndex {
+public:
+  /// Everything we know about the findings with one signature.
+  struct Bucket {
+    /// How many hits had this signature.
+    size_t hits = 0;
+    /// How many of those hits were reduced.
+    size_t reductions = 0;
+    /// The number of nodes of the smallest hit that was reduced.
+    size_t smallestNodes = 0;
+  };
+
+  /// Records a hit with the given signature and program size (in nodes).
+  ///
+  /// @return True if the hit should be reduced. Hits without a signature are
+  ///         always reduced.
+  bool addHit(const std::string &signature, size_t nodes);
+
+  /// Sets how many hits of every signature are reduced (unless a later hit
+  /// is smaller).
+  void setReductionsPerSignature(size_t n) { reductionsPerSignature = n; }
+
+  /// Returns the number of hits that were not reduced.
+  size_t getDuplicates() const { return duplicates; }
+
+  /// Returns the number of distinct signatures seen so far.
+  size_t getNumSignatures() const { return buckets.size(); }
+
+  const std::map<std::string, Bucket> &getBuckets() const { return buckets; }
+
+  /// Writes the buckets and statistics, but not the settings.
+  void save(BinaryWriter &w) const;
+  void load(BinaryReader &r);
+
+private:
+  std::map<std::string, Bucket> buckets;
+  size_t reductionsPerSignature = 1;
+  size_t duplicates = 0;
+};
+
+#endif // SIGNATUREINDEX_H
@@ -2,17 +2,22 @@
 #define STRATEGYBASE_H
 
 #include "Rng.h"
+#include "scc/utils/Error.h"
+
 #include <algorithm>
+#include <sstream>
 #include <vector>
 
 /// Contains methods for creating a list of weighted decisions.
 template <typename Derived, typename DerivedFrag> class StrategyBase {
 public:
+  typedef DerivedFrag Frag;
+
   /// Assign every decision a random chance.
   void randomize(Rng &rng) {
     for (float &v : values)
       if (rng.withSuccessChance(0.1f))
-        v += legalizeValue((rng.getMin1To1() * 0.4f) + 0.5f);
+        v = legalizeValue((rng.getMin1To1() * 0.4f) + 0.5f);
     name = "Random strategy " + std::to_string(generation);
     ++generation;
     if (rng.withSuccessChance(0.7f))
@@ -20,6 +25,54 @@ public:
     scale = std::clamp<unsigned>(scale, 1, 10);
   }
 
+  /// Mixes the decision chances of this strategy with the given strategy.
+  ///
+  /// Every decision chance (and the scale) is taken with equal probability
+  /// from either this or the other strategy.
+  void crossover(const Derived &other, Rng &rng) {
+    SCCAssertEqual(values.size(), other.values.size(),
+                   "Mixing strategies of different types?");
+    for (size_t i = 0; i < values.size(); ++i)
+      if (rng.flipCoin())
+        values.at(i) = other.values.at(i);
+    if (rng.flipCoin())
+      scale = other.scale;
+    generation = std::max(generation, other.generation);
+  }
+
+  /// Bounds for decision chances that are adjusted by `reinforce`.
+  static constexpr float minLearnedChance = 0.01f;
+  static constexpr float maxLearnedChance = 0.99f;
+  /// How much weaker a failed mutation is punished compared to how much a
+  /// successful mutation is rewarded. Most mutations fail, so this has to be
+  /// small to not drive every chance to the minimum.
+  static constexpr float failurePenalty = 0.1f;
+
+  /// Nudges the chances of the given decisions towards 1 if they were part
+  /// of a successful mutation, or towards 0 otherwise.
+  ///
+  /// Every decision is adjusted once, regardless of how often it was taken.
+  /// Decisions that are disabled (0) or forced (1) by the strategy are left
+  /// alone and adjusted chances never leave the learned chance bounds.
+  void reinforce(const std::vector<DerivedFrag> &taken, bool success,
+                 float rate) {
+    std::vector<bool> seen(values.size(), false);
+    for (DerivedFrag f : taken) {
+      const std::size_t i = getIndex(f);
+      if (seen.at(i))
+        continue;
+      seen.at(i) = true;
+      float &v = values.at(i);
+      if (v <= 0.0f || v >= 1.0f)
+        continue;
+      if (success)
+        v += rate * (1.0f - v);
+      else
+        v -= rate * failurePenalty * v;
+      v = std::clamp(v, minLearnedChance, maxLearnedChance);
+    }
+  }
+
   unsigned generation = 1;
   unsigned scale = 1;
 
@@ -43,6 +96,41 @@ public:
 
   void setName(std::string n) { name = n; }
 
+  /// Returns a single-line textual representation of this strategy.
+  ///
+  /// @see deserialize
+  std::string serialize() const {
+    std::stringstream res;
+    res << name << "\t" << generation << "\t" << scale;
+    for (float v : values)
+      res << "\t" << v;
+    return res.str();
+  }
+
+  /// Parses a strategy from the format produced by `serialize`.
+  ///
+  /// The line has to have as many decision chances as this strategy.
+  OptError deserialize(const std::string &line) {
+    std::vector<std::string> parts;
+    std::stringstream stream(line);
+    std::string part;
+    while (std::getline(stream, part, '\t'))
+      parts.push_back(part);
+    if (parts.size() != values.size() + 3)
+      return Err("Expected " + std::to_string(values.size()) +
+                 " decision chances in strategy line: " + line);
+    try {
+      name = parts.at(0);
+      generation = std::stoul(parts.at(1));
+      scale = std::clamp<unsigned>(std::stoul(parts.at(2)), 1, 10);
+      for (size_t i = 0; i < values.size(); ++i)
+        values.at(i) = legalizeValue(std::stof(parts.at(i + 3)));
+    } catch (const std::exception &e) {
+      return Err("Malformed strategy line: " + line);
+    }
+    return {};
+  }
+
 protected:
   float legalizeValue(float v) { return std::max(0.0f, std::min(1.0f, v)); }
   std::size_t getIndex(DerivedFrag f) const {
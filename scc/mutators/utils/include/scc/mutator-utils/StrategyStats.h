@@ -0,0 +1,107 @@
+#ifndef STRATEGYSTATS_H
+#define STRATEGYSTATS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "scc/utils/BinaryStream.h"
+
+/// Bookkeeping of how much a mutation strategy gained and what it cost.
+///
+/// All times are wall-clock microseconds summed over all runs of the strategy.
+struct StrategyStats {
+  /// How many points we have gained by using this mutation strategy.
+  size_t scoreGained = 0;
+  /// How often this strategy has been applied.
+  size_t runs = 1;
+  /// How many mutations were rejected before reaching the oracle (e.g.,
+  /// because they hit the cache or couldn't be printed).
+  size_t rejected = 0;
+
+  /// Time spent in the mutator.
+  uint64_t mutateMicros = 0;
+  /// Time spent printing/hashing the mutated program.
+  uint64_t printMicros = 0;
+  /// Time spent waiting for the oracle.
+  uint64_t oracleMicros = 0;
+
+  /// Assumed cost of a single run when we have no measurements yet. Prevents
+  /// that a strategy with a lucky first run gets an infinite weight.
+  static constexpr uint64_t costPriorMicros = 1000;
+
+  /// Returns the total CPU time (in seconds) spent on this strategy.
+  double getCPUSeconds() const {
+    const uint64_t micros =
+        mutateMicros + printMicros + oracleMicros + runs * costPriorMicros;
+    return micros / 1000000.0;
+  }
+
+  /// Returns how many points this strategy gained per second of CPU time.
+  double getGainPerCPUSecond() const { return scoreGained / getCPUSeconds(); }
+
+  /// Returns the percentage (0-100) of runs that never reached the oracle.
+  size_t getRejectionRate() const { return rejected * 100U / runs; }
+
+  /// Returns the average time in microseconds a run spent in the given
+  /// timer.
+  uint64_t perRun(uint64_t micros) const { return micros / runs; }
+
+  /// When picking a random strategy, how much weight should be given to this
+  /// strategy.
+  size_t getPickWeight() const {
+    return std::max<size_t>(1, getGainPerCPUSecond() * 1000);
+  }
+
+  /// Called when this strategy has been used to do a mutation.
+  /// \param gained How many points we gained by using this strategy (or 0
+  ///        if we gained no additional points)
+  void didRun(size_t gained) {
+    ++runs;
+    scoreGained += gained;
+  }
+
+  /// Called when a mutation of this strategy was rejected before it
+  /// reached the oracle.
+  void didReject() {
+    ++runs;
+    ++rejected;
+  }
+
+  void hitCache() {
+    didReject();
+    if (scoreGained == 0)
+      return;
+    scoreGained -= 1;
+  }
+
+  void save(BinaryWriter &w) const {
+    w.writeUInt(scoreGained);
+    w.writeUInt(runs);
+    w.writeUInt(rejected);
+    w.writeUInt(mutateMicros);
+    w.writeUInt(printMicros);
+    w.writeUInt(oracleMicros);
+  }
+
+  void load(BinaryReader &r) {
+    scoreGained = r.readUInt();
+    // Runs start at 1 so the rates never divide by zero.
+    runs = std::max<size_t>(1, r.readUInt());
+    rejected = r.readUInt();
+    mutateMicros = r.readUInt();
+    printMicros = r.readUInt();
+    oracleMicros = r.readUInt();
+  }
+};
+
+/// The statistics of a strategy with the name of the strategy.
+struct NamedStrategyStats {
+  std::string name;
+  StrategyStats stats;
+  /// The chance (0-100) that this strategy is picked.
+  size_t chance = 0;
+};
+
+#endif // STRATEGYSTATS_H
@@ -0,0 +1,98 @@
+#ifndef SURROGATEMODEL_H
+#define SURROGATEMODEL_H
+
+#include "Rng.h"
+#include "scc/program/Program.h"
+#include "scc/utils/BinaryStream.h"
+
+#include <deque>
+#include <vector>
+
+/// An online logistic regression that predicts whether running the oracle on
+/// a mutated program pays off (i.e., whether the program improves the queue).
+///
+/// The model is trained on cheap features of the program (a histogram of the
+/// statement kinds, the number of declarations and types and the number of
+/// calls to builtin functions) and the feedback of every oracle run. After a
+/// warmup period, candidates with the lowest predictions are skipped without
+/// running the oracle. A small fraction of them is evaluated anyway to keep
+/// training the model and to measure how good its predictions are.
+class SurrogateModel {
+public:
+  typedef std::vector<float> Features;
+
+  /// Returns the features of the given program.
+  static Features extract(const Program &p);
+
+  struct Prediction {
+    /// The predicted chance that the program is useful.
+    float chance = 1;
+    /// True if the chance is in the fraction of candidates that should be
+    /// skipped.
+    bool lowValue = false;
+    /// True if the candidate should be skipped (false for low value
+    /// candidates that are explored).
+    bool skip = false;
+  };
+
+  /// Predicts the value of a candidate with the given features.
+  Prediction predict(const Features &f, Rng &rng);
+
+  /// Trains the model with the outcome of an oracle run.
+  ///
+  /// @param useful Whether the program improved the queue.
+  void train(const Features &f, const Prediction &p, bool useful);
+
+  /// Sets the fraction of candidates that are skipped (0 to 1).
+  void setSkipFraction(double f) { skipFraction = f; }
+  /// Sets how many low value candidates are still evaluated (0 to 1).
+  void setExplorationRate(double r) { explorationRate = r; }
+  /// Sets after how many oracle runs the model starts skipping candidates.
+  void setWarmup(size_t runs) { warmup = runs; }
+
+  /// Returns the number of skipped candidates.
+  size_t getSkipped() const { return skipped; }
+  /// Returns the number of oracle runs the model was trained on.
+  size_t getTrained() const { return trained; }
+
+  /// Of the evaluated candidates that were predicted to be low value, the
+  /// fraction that really were useless (in percent).
+  size_t getPrecision() const;
+  /// Of the evaluated candidates that were useless, the fraction that was
+  /// predicted to be low value (in percent).
+  size_t getRecall() const;
+
+  /// Writes what the model learned and its statistics, but not the settings.
+  void save(BinaryWriter &w) const;
+  void load(BinaryReader &r);
+
+private:
+  std::vector<float> weights;
+  float bias = 0;
+  float learningRate = 0.05f;
+
+  double skipFraction = 0.5;
+  double explorationRate = 0.1;
+  size_t warmup = 200;
+
+  /// The most recent predictions used to find the skip threshold.
+  std::deque<float> recentChances;
+  static constexpr size_t maxRecentChances = 512;
+
+  size_t skipped = 0;
+  size_t trained = 0;
+  // Only a fraction of the low value candidates is evaluated, so they are
+  // weighted by the inverse exploration rate.
+  /// Useless candidates that were predicted to be low value.
+  double truePositives = 0;
+  /// Useful candidates that were predicted to be low value.
+  double falsePositives = 0;
+  /// Useless candidates that were not predicted to be low value.
+  double falseNegatives = 0;
+
+  float computeChance(const Features &f) const;
+  /// Returns the chance below which candidates are low value.
+  float getThreshold() const;
+};
+
+#endif // SURROGATEMODEL_H
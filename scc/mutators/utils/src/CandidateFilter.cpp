@@ -0,0 +1,97 @@
+#include "scc/mutator-utils/CandidateFilter.h"
+
+#include "scc/program/GlobalVar.h"
+
+namespace {
+/// Calls `f` on the body of every function and the initializer of every
+/// global variable until it returns true.
+bool anyRootStatement(const Program &p,
+                      const std::function<bool(const Statement &)> &f) {
+  for (const Decl *d : p.getDeclList()) {
+    if (d->getKind() == Decl::Kind::Function) {
+      const Function *func = static_cast<const Function *>(d);
+      if (!func->isExternal() && f(func->getBody()))
+        return true;
+    } else if (d->getKind() == Decl::Kind::GlobalVar) {
+      if (f(static_cast<const GlobalVar *>(d)->getInit()))
+        return true;
+    }
+  }
+  return false;
+}
+
+bool isDeeperThan(const Statement &s, size_t depth) {
+  if (depth == 0)
+    return true;
+  for (const Statement &child : s)
+    if (isDeeperThan(child, depth - 1))
+      return true;
+  return false;
+}
+
+bool isForbidden(const Statement &s, const LangOpts &opts) {
+  switch (s.getKind()) {
+  case Statement::Kind::Asm:
+    return !opts.hasAsm();
+  case Statement::Kind::New:
+  case Statement::Kind::Delete:
+    return !opts.isCxx();
+  case Statement::Kind::Throw:
+  case Statement::Kind::Try:
+  case Statement::Kind::Catch:
+    return !opts.isCxx() || !opts.hasExceptions();
+  default:
+    return false;
+  }
+}
+} // namespace
+
+void CandidateFilter::add(std::string name, RejectFunc f) {
+  Filter filter;
+  filter.name = name;
+  filter.rejects = f;
+  filters.push_back(filter);
+}
+
+bool CandidateFilter::rejects(const Candidate &c) {
+  for (Filter &f : filters) {
+    if (f.rejects(c)) {
+      ++f.rejections;
+      return true;
+    }
+  }
+  return false;
+}
+
+CandidateFilter::RejectFunc CandidateFilter::maxNodes(size_t n) {
+  return [n](const Candidate &c) { return c.p.countNodes() > n; };
+}
+
+CandidateFilter::RejectFunc CandidateFilter::maxBytes(size_t n) {
+  return [n](const Candidate &c) { return c.digest.size > n; };
+}
+
+CandidateFilter::RejectFunc CandidateFilter::maxDepth(size_t n) {
+  return [n](const Candidate &c) {
+    // The function body itself doesn't count as nesting.
+    return anyRootStatement(
+        c.p, [n](const Statement &s) { return isDeeperThan(s, n + 1); });
+  };
+}
+
+CandidateFilter::RejectFunc CandidateFilter::forbiddenConstructs() {
+  return [](const Candidate &c) {
+    const LangOpts &opts = c.p.getLangOpts();
+    return anyRootStatement(c.p, [&opts](const Statement &root) {
+      return root.foreachChild([&opts](const Statement &s) {
+        return isForbidden(s, opts) ? LoopCtrl::Abort : LoopCtrl::Continue;
+      }) == LoopCtrl::Abort;
+    });
+  };
+}
+
+CandidateFilter::RejectFunc CandidateFilter::unchangedFromParent() {
+  return [](const Candidate &c) {
+    return c.parentHash != 0 && c.digest.hash == c.parentHash;
+  };
+}
@@ -0,0 +1,78 @@
+#include "scc/mutator-utils/Checkpoint.h"
+
+#include "scc/utils/BinaryStream.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace {
+const char *magic = "SCCK";
+
+/// FNV-1a.
+uint64_t checksum(const std::string &data) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (char c : data) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+} // namespace
+
+std::string Checkpoint::getPath(const std::string &dir) {
+  return (std::filesystem::path(dir) / "checkpoint.bin").string();
+}
+
+OptError Checkpoint::write(const std::string &dir, const std::string &state) {
+  std::error_code ec;
+  std::filesystem::create_directories(dir, ec);
+  if (ec)
+    return Err("Failed to create checkpoint directory " + dir + ": " +
+               ec.message());
+
+  BinaryWriter w;
+  w.writeString(magic);
+  w.writeUInt(version);
+  w.writeUInt(checksum(state));
+  w.writeString(state);
+
+  const std::string path = getPath(dir);
+  const std::string tmpPath = path + ".tmp";
+  {
+    std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+    out << w.getData();
+    if (!out)
+      return Err("Failed to write checkpoint to " + tmpPath);
+  }
+  // Rename so that we never leave a half-written checkpoint behind.
+  std::filesystem::rename(tmpPath, path, ec);
+  if (ec)
+    return Err("Failed to rename " + tmpPath + ": " + ec.message());
+  return {};
+}
+
+Maybe<std::string> Checkpoint::read(const std::string &dir) {
+  const std::string path = getPath(dir);
+  std::ifstream in(path, std::ios::binary);
+  if (!in)
+    return Err("Failed to open checkpoint " + path);
+  std::stringstream buffer;
+  buffer << in.rdbuf();
+  const std::string data = buffer.str();
+
+  BinaryReader r(data);
+  if (r.readString() != magic)
+    return Err(path + " is not a checkpoint");
+  const uint64_t readVersion = r.readUInt();
+  if (readVersion != version)
+    return Err("Unsupported checkpoint version " +
+               std::to_string(readVersion) + " in " + path);
+  const uint64_t expectedChecksum = r.readUInt();
+  std::string state = r.readString();
+  if (r.hasFailed())
+    return Err("Truncated checkpoint " + path);
+  if (checksum(state) != expectedChecksum)
+    return Err("Checksum mismatch in checkpoint " + path);
+  return state;
+}
@@ -0,0 +1,415 @@
+#include "scc/mutator-utils/Cluster.h"
+
+#include "scc/utils/Stopwatch.h"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+/// Frames larger than this are treated as a broken connection.
+constexpr size_t maxFrameSize = size_t(1) << 28;
+constexpr size_t frameHeaderSize = 4;
+
+/// A parsed 'unix:PATH' or 'tcp:HOST:PORT' address.
+struct Address {
+  int family = AF_UNIX;
+  sockaddr_un un = {};
+  sockaddr_in in = {};
+
+  const sockaddr *get() const {
+    if (family == AF_UNIX)
+      return reinterpret_cast<const sockaddr *>(&un);
+    return reinterpret_cast<const sockaddr *>(&in);
+  }
+  socklen_t size() const {
+    return family == AF_UNIX ? sizeof(un) : sizeof(in);
+  }
+};
+
+Maybe<Address> parseAddress(const std::string &str) {
+  Address res;
+  const std::string unixPrefix = "unix:";
+  const std::string tcpPrefix = "tcp:";
+  if (str.rfind(unixPrefix, 0) == 0) {
+    const std::string path = str.substr(unixPrefix.size());
+    if (path.empty() || path.size() >= sizeof(res.un.sun_path))
+      return Err("Invalid socket path in " + str);
+    res.un.sun_family = AF_UNIX;
+    std::strncpy(res.un.sun_path, path.c_str(), sizeof(res.un.sun_path) - 1);
+    return res;
+  }
+  if (str.rfind(tcpPrefix, 0) == 0) {
+    const std::string hostPort = str.substr(tcpPrefix.size());
+    const size_t colon = hostPort.rfind(':');
+    if (colon == std::string::npos)
+      return Err("Missing port in " + str);
+    res.family = AF_INET;
+    res.in.sin_family = AF_INET;
+    if (inet_pton(AF_INET, hostPort.substr(0, colon).c_str(),
+                  &res.in.sin_addr) != 1)
+      return Err("Invalid IPv4 address in " + str);
+    const std::string port = hostPort.substr(colon + 1);
+    if (port.empty() || port.find_first_not_of("0123456789") !=
+                            std::string::npos || std::stoul(port) > 65535)
+      return Err("Invalid port in " + str);
+    res.in.sin_port = htons(static_cast<uint16_t>(std::stoul(port)));
+    return res;
+  }
+  return Err("Address has to start with 'unix:' or 'tcp:': " + str);
+}
+
+Error errnoError(const std::string &what) {
+  return Err(what + ": " + std::strerror(errno));
+}
+
+void disableNagle(int fd) {
+  int one = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+} // namespace
+
+ClusterConnection::~ClusterConnection() { close(fd); }
+
+Maybe<std::unique_ptr<ClusterConnection>>
+ClusterConnection::connect(const std::string &address) {
+  Maybe<Address> addr = parseAddress(address);
+  if (addr.isErr())
+    return addr.takeError();
+  const int fd = socket(addr->family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0)
+    return errnoError("Failed to create socket");
+  if (::connect(fd, addr->get(), addr->size()) != 0) {
+    Error err = errnoError("Failed to connect to " + address);
+    close(fd);
+    return err;
+  }
+  if (addr->family == AF_INET)
+    disableNagle(fd);
+  return std::make_unique<ClusterConnection>(fd);
+}
+
+void ClusterConnection::queueFrame(std::string_view payload) {
+  const uint32_t size = payload.size();
+  for (unsigned i = 0; i < frameHeaderSize; ++i)
+    out.push_back(static_cast<char>(size >> (i * 8)));
+  out.append(payload);
+}
+
+bool ClusterConnection::flush() {
+  size_t sent = 0;
+  while (sent < out.size()) {
+    const ssize_t n =
+        send(fd, out.data() + sent, out.size() - sent, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR)
+      continue;
+    // The socket buffer is full, send the rest later.
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+      break;
+    if (n <= 0)
+      return false;
+    sent += n;
+  }
+  out.erase(0, sent);
+  return true;
+}
+
+bool ClusterConnection::receive() {
+  char buf[1 << 16];
+  while (true) {
+    const ssize_t n = recv(fd, buf, sizeof(buf), 0);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+      return true;
+    if (n <= 0)
+      return false;
+    in.append(buf, n);
+    return getPendingFrameSize() <= maxFrameSize;
+  }
+}
+
+size_t ClusterConnection::getPendingFrameSize() const {
+  size_t size = 0;
+  if (in.size() >= frameHeaderSize)
+    for (unsigned i = 0; i < frameHeaderSize; ++i)
+      size |= size_t(static_cast<uint8_t>(in[i])) << (i * 8);
+  return size;
+}
+
+std::optional<std::string> ClusterConnection::popFrame() {
+  if (in.size() < frameHeaderSize)
+    return std::nullopt;
+  const size_t size = getPendingFrameSize();
+  if (in.size() < frameHeaderSize + size)
+    return std::nullopt;
+  std::string res = in.substr(frameHeaderSize, size);
+  in.erase(0, frameHeaderSize + size);
+  return res;
+}
+
+std::optional<std::string> ClusterConnection::waitForFrame() {
+  while (true) {
+    if (std::optional<std::string> frame = popFrame())
+      return frame;
+    // Also wait for data on non-blocking sockets.
+    pollfd pfd = {fd, POLLIN, 0};
+    if (::poll(&pfd, 1, -1) < 0 && errno != EINTR)
+      return std::nullopt;
+    if (!receive())
+      return std::nullopt;
+  }
+}
+
+ClusterListener::~ClusterListener() {
+  close(fd);
+  if (!unixPath.empty())
+    unlink(unixPath.c_str());
+}
+
+Maybe<std::unique_ptr<ClusterListener>>
+ClusterListener::listen(const std::string &address) {
+  Maybe<Address> addr = parseAddress(address);
+  if (addr.isErr())
+    return addr.takeError();
+  // Non-blocking so that accept() returns if no worker is waiting.
+  const int fd =
+      socket(addr->family, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+  if (fd < 0)
+    return errnoError("Failed to create socket");
+
+  std::string unixPath;
+  if (addr->family == AF_UNIX) {
+    unixPath = addr->un.sun_path;
+    // Remove the socket file of a previous coordinator.
+    unlink(unixPath.c_str());
+  } else {
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  }
+  if (bind(fd, addr->get(), addr->size()) != 0 || ::listen(fd, 64) != 0) {
+    Error err = errnoError("Failed to listen on " + address);
+    close(fd);
+    return err;
+  }
+
+  std::string boundAddress = address;
+  if (addr->family == AF_INET) {
+    // Report the port that was picked for port 0.
+    sockaddr_in bound = {};
+    socklen_t len = sizeof(bound);
+    getsockname(fd, reinterpret_cast<sockaddr *>(&bound), &len);
+    char host[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &bound.sin_addr, host, sizeof(host));
+    boundAddress = "tcp:" + std::string(host) + ":" +
+                   std::to_string(ntohs(bound.sin_port));
+  }
+  return std::unique_ptr<ClusterListener>(
+      new ClusterListener(fd, unixPath, boundAddress));
+}
+
+std::unique_ptr<ClusterConnection> ClusterListener::accept() {
+  const int conn =
+      accept4(fd, nullptr, nullptr, SOCK_CLOEXEC | SOCK_NONBLOCK);
+  if (conn < 0)
+    return nullptr;
+  if (unixPath.empty())
+    disableNagle(conn);
+  return std::make_unique<ClusterConnection>(conn);
+}
+
+Maybe<std::unique_ptr<ClusterCoordinator>>
+ClusterCoordinator::listen(SchedulerBase &sched, StepFunc stepFunc,
+                           const std::string &address) {
+  Maybe<std::unique_ptr<ClusterListener>> listener =
+      ClusterListener::listen(address);
+  if (listener.isErr())
+    return listener.takeError();
+  return std::unique_ptr<ClusterCoordinator>(
+      new ClusterCoordinator(sched, std::move(stepFunc), std::move(*listener)));
+}
+
+// A request is the number of wanted jobs followed by the results of the
+// last batch. A reply is whether fuzzing finished, the dictionary if it
+// changed and the new jobs.
+bool ClusterCoordinator::handleRequest(Worker &w, std::string_view request) {
+  BinaryReader r(request);
+  const size_t wanted = std::min<size_t>(r.readUInt(), maxBatchSize);
+  const size_t numResults = r.readSize();
+  for (size_t i = 0; i < numResults && !r.hasFailed(); ++i) {
+    SchedulerBase::ClusterResult res;
+    res.load(r);
+    // Only accept results of jobs that this worker was given.
+    if (r.hasFailed() || w.jobs.erase(res.jobId) == 0)
+      continue;
+    sched.applyClusterResult(res);
+    ++completedJobs;
+  }
+  if (r.hasFailed() || !r.atEnd())
+    return false;
+
+  BinaryWriter reply;
+  const bool finished = sched.fuzzingFinished();
+  reply.writeBool(finished);
+  std::shared_ptr<const ConstantDictionary> dictionary = sched.getDictionary();
+  reply.writeBool(dictionary != w.dictionary);
+  if (dictionary != w.dictionary) {
+    dictionary->save(reply);
+    w.dictionary = dictionary;
+  }
+
+  std::vector<SchedulerBase::ClusterJob> jobs;
+  while (!finished && jobs.size() < wanted) {
+    std::optional<SchedulerBase::ClusterJob> job = sched.makeClusterJob();
+    if (!job)
+      break;
+    w.jobs.emplace(job->id, Stopwatch());
+    jobs.push_back(std::move(*job));
+  }
+  reply.writeUInt(jobs.size());
+  for (const SchedulerBase::ClusterJob &job : jobs)
+    job.save(reply);
+  w.conn->queueFrame(reply.getData());
+  return w.conn->flush();
+}
+
+void ClusterCoordinator::dropWorker(std::list<Worker>::iterator w) {
+  for (const auto &job : w->jobs)
+    sched.dropClusterJob(job.first);
+  // Workers without jobs just stopped after fuzzing finished.
+  if (!w->jobs.empty())
+    ++lostWorkers;
+  lostJobs += w->jobs.size();
+  workers.erase(w);
+}
+
+void ClusterCoordinator::dropTimedOutJobs() {
+  if (jobTimeoutMicros == 0)
+    return;
+  for (Worker &w : workers)
+    for (auto job = w.jobs.begin(); job != w.jobs.end();) {
+      if (job->second.getMicros() < jobTimeoutMicros) {
+        ++job;
+        continue;
+      }
+      sched.dropClusterJob(job->first);
+      ++timedOutJobs;
+      job = w.jobs.erase(job);
+    }
+}
+
+void ClusterCoordinator::poll(int timeoutMillis) {
+  dropTimedOutJobs();
+
+  // Foreground reductions and background reductions after fuzzing finished
+  // are advanced by the scheduler itself.
+  if (sched.isReducing()) {
+    // Spend the time slice on the reduction and only answer the requests
+    // that are already waiting.
+    Stopwatch timer;
+    while (sched.isReducing() && timer.getMicros() < timeoutMillis * 1000U)
+      stepFunc();
+    timeoutMillis = 0;
+  } else if (sched.fuzzingFinished()) {
+    stepFunc();
+  }
+
+  std::vector<pollfd> fds;
+  fds.push_back({listener->getFD(), POLLIN, 0});
+  for (const Worker &w : workers) {
+    const short events =
+        w.conn->hasPendingOutput() ? POLLIN | POLLOUT : POLLIN;
+    fds.push_back({w.conn->getFD(), events, 0});
+  }
+  if (::poll(fds.data(), fds.size(), timeoutMillis) <= 0)
+    return;
+
+  auto fd = std::next(fds.begin());
+  for (auto w = workers.begin(); w != workers.end(); ++fd) {
+    auto current = w++;
+    if (fd->revents == 0)
+      continue;
+    // Send the rest of earlier replies first.
+    bool ok = current->conn->flush();
+    if (ok && (fd->revents & ~POLLOUT))
+      ok = current->conn->receive();
+    while (ok) {
+      std::optional<std::string> request = current->conn->popFrame();
+      if (!request)
+        break;
+      ok = handleRequest(*current, *request);
+    }
+    if (!ok)
+      dropWorker(current);
+  }
+
+  if (fds.front().revents & POLLIN)
+    if (std::unique_ptr<ClusterConnection> conn = listener->accept()) {
+      workers.push_back(Worker());
+      workers.back().conn = std::move(conn);
+    }
+}
+
+Maybe<std::unique_ptr<ClusterWorker>>
+ClusterWorker::connect(SchedulerBase &sched, const std::string &address,
+                       size_t batchSize) {
+  Maybe<std::unique_ptr<ClusterConnection>> conn =
+      ClusterConnection::connect(address);
+  if (conn.isErr())
+    return conn.takeError();
+  batchSize = std::clamp<size_t>(batchSize, 1,
+                                 ClusterCoordinator::maxBatchSize);
+  return std::unique_ptr<ClusterWorker>(
+      new ClusterWorker(sched, std::move(*conn), batchSize));
+}
+
+bool ClusterWorker::step() {
+  BinaryWriter request;
+  request.writeUInt(batchSize);
+  request.writeUInt(results.size());
+  for (const SchedulerBase::ClusterResult &res : results)
+    res.save(request);
+  results.clear();
+  conn->queueFrame(request.getData());
+  if (!conn->flush())
+    return false;
+
+  std::optional<std::string> reply = conn->waitForFrame();
+  if (!reply)
+    return false;
+  BinaryReader r(*reply);
+  if (r.readBool())
+    return false;
+  if (r.readBool()) {
+    auto dictionary = std::make_shared<ConstantDictionary>();
+    // The coordinator already limits the size.
+    dictionary->setCapacity(std::numeric_limits<size_t>::max());
+    dictionary->load(r);
+    sched.setDictionary(dictionary);
+  }
+  const size_t numJobs = r.readSize();
+  for (size_t i = 0; i < numJobs && !r.hasFailed(); ++i) {
+    SchedulerBase::ClusterJob job;
+    job.load(r);
+    if (r.hasFailed())
+      break;
+    results.push_back(sched.runClusterJob(job));
+    ++completedJobs;
+  }
+  if (r.hasFailed())
+    return false;
+  // The coordinator is busy, e.g. with reducing a finding.
+  if (numJobs == 0)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  return true;
+}
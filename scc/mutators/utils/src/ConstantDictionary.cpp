@@ -0,0 +1,84 @@
+#include "scc/mutator-utils/ConstantDictionary.h"
+
+#include <algorithm>
+
+std::vector<ConstantDictionary::Entry>::iterator
+ConstantDictionary::leastFrequent() {
+  // min_element returns the first (and therefore oldest) entry on ties.
+  return std::min_element(entries.begin(), entries.end(),
+                          [](const Entry &l, const Entry &r) {
+                            return l.frequency < r.frequency;
+                          });
+}
+
+void ConstantDictionary::add(const std::string &type,
+                             const std::string &value) {
+  for (Entry &e : entries) {
+    if (e.type == type && e.value == value) {
+      e.frequency += 1;
+      return;
+    }
+  }
+  if (capacity == 0)
+    return;
+  if (entries.size() >= capacity)
+    entries.erase(leastFrequent());
+  entries.push_back({type, value, 1});
+}
+
+bool ConstantDictionary::addFromOracle(const std::string &entry) {
+  const size_t sep = entry.find(':');
+  if (sep == std::string::npos || sep == 0 || sep + 1 == entry.size())
+    return false;
+  add(entry.substr(0, sep), entry.substr(sep + 1));
+  return true;
+}
+
+std::optional<std::string>
+ConstantDictionary::pick(Rng &rng, const std::string &type) const {
+  size_t totalWeight = 0;
+  for (const Entry &e : entries)
+    if (e.type == type || e.type == "*")
+      totalWeight += e.frequency;
+  if (totalWeight == 0)
+    return {};
+
+  size_t selected = rng.getBelow(totalWeight - 1);
+  for (const Entry &e : entries) {
+    if (e.type != type && e.type != "*")
+      continue;
+    if (selected < e.frequency)
+      return e.value;
+    selected -= e.frequency;
+  }
+  SCCError("Failed to pick dictionary entry?");
+}
+
+void ConstantDictionary::setCapacity(size_t c) {
+  capacity = c;
+  while (entries.size() > capacity)
+    entries.erase(leastFrequent());
+}
+
+void ConstantDictionary::save(BinaryWriter &w) const {
+  w.writeUInt(entries.size());
+  for (const Entry &e : entries) {
+    w.writeString(e.type);
+    w.writeString(e.value);
+    w.writeUInt(e.frequency);
+  }
+}
+
+void ConstantDictionary::load(BinaryReader &r) {
+  entries.clear();
+  const size_t size = r.readSize();
+  for (size_t i = 0; i < size && !r.hasFailed(); ++i) {
+    Entry e;
+    e.type = r.readString();
+    e.value = r.readString();
+    e.frequency = r.readUInt();
+    entries.push_back(e);
+  }
+  while (entries.size() > capacity)
+    entries.erase(leastFrequent());
+}
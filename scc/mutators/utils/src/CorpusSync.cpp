@@ -0,0 +1,108 @@
+#include "scc/mutator-utils/CorpusSync.h"
+
+#include "scc/mutator-utils/SeedCorpus.h"
+#include "scc/program/ProgramSerializer.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+std::string hashToName(HashStream::Hash hash) {
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), "%016" PRIx64,
+                static_cast<uint64_t>(hash));
+  return buf;
+}
+
+/// Parses the hash in the given file name. Returns false if the name isn't a
+/// hash.
+bool nameToHash(const std::string &name, HashStream::Hash &hash) {
+  if (name.size() != 16)
+    return false;
+  if (name.find_first_not_of("0123456789abcdef") != std::string::npos)
+    return false;
+  hash = static_cast<HashStream::Hash>(std::stoull(name, nullptr, 16));
+  return true;
+}
+} // namespace
+
+CorpusSync::CorpusSync(std::string dir, std::string name, bool primary)
+    : dir(dir), name(name), primary(primary) {}
+
+std::string CorpusSync::getInstanceDir(const std::string &instance) const {
+  return (std::filesystem::path(dir) / instance).string();
+}
+
+OptError CorpusSync::init() {
+  const std::string ownDir = getInstanceDir(name);
+  std::error_code ec;
+  std::filesystem::create_directories(ownDir, ec);
+  if (ec)
+    return Err("Failed to create sync directory " + ownDir + ": " +
+               ec.message());
+  if (primary) {
+    std::ofstream marker(ownDir + "/" + primaryMarker);
+    if (!marker)
+      return Err("Failed to mark " + ownDir + " as primary");
+  }
+  return {};
+}
+
+OptError CorpusSync::exportProgram(const Program &p, HashStream::Hash hash) {
+  if (!seen.insert(hash).second)
+    return {};
+  const std::string path =
+      getInstanceDir(name) + "/" + hashToName(hash) + SeedCorpus::extension;
+  // The temporary file doesn't have the extension, so it's never imported.
+  const std::string tmpPath = path + ".tmp";
+  if (OptError err = ProgramSerializer::save(tmpPath, p))
+    return err;
+  std::error_code ec;
+  std::filesystem::rename(tmpPath, path, ec);
+  if (ec)
+    return Err("Failed to rename " + tmpPath + ": " + ec.message());
+  ++exported;
+  return {};
+}
+
+std::vector<std::string> CorpusSync::getImportDirs() const {
+  std::vector<std::string> res;
+  std::error_code ec;
+  for (const auto &entry : std::filesystem::directory_iterator(dir, ec)) {
+    if (!entry.is_directory() || entry.path().filename() == name)
+      continue;
+    if (!primary && !std::filesystem::exists(entry.path() / primaryMarker))
+      continue;
+    res.push_back(entry.path().string());
+  }
+  std::sort(res.begin(), res.end());
+  return res;
+}
+
+std::vector<Program> CorpusSync::importNew(size_t budget) {
+  std::vector<Program> res;
+  for (const std::string &instanceDir : getImportDirs()) {
+    std::error_code ec;
+    for (const auto &entry :
+         std::filesystem::directory_iterator(instanceDir, ec)) {
+      if (res.size() >= budget)
+        return res;
+      if (entry.path().extension() != SeedCorpus::extension)
+        continue;
+      HashStream::Hash hash;
+      if (!nameToHash(entry.path().stem().string(), hash))
+        continue;
+      if (!seen.insert(hash).second)
+        continue;
+      Maybe<Program> p = ProgramSerializer::load(entry.path().string());
+      if (p.isErr())
+        continue;
+      res.push_back(std::move(*p));
+      ++imported;
+    }
+  }
+  return res;
+}
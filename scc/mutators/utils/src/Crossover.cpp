@@ -0,0 +1,311 @@
+#include "scc/mutator-utils/Crossover.h"
+
+#include "scc/program/GlobalVar.h"
+#include "scc/program/RecordDecl.h"
+
+#include <set>
+
+namespace {
+Decl *findDecl(const Program &p, NameID id) {
+  for (Decl *d : p.getDeclList())
+    if (static_cast<NamedDecl *>(d)->getNameID() == id)
+      return d;
+  return nullptr;
+}
+
+/// Returns the name without the trailing number (e.g. 'var' for 'var12').
+std::string getNamePrefix(const std::string &name) {
+  size_t end = name.size();
+  while (end > 0 && std::isdigit(static_cast<unsigned char>(name[end - 1])))
+    --end;
+  if (end == 0)
+    return "i";
+  return name.substr(0, end);
+}
+
+/// Returns true if the statement only uses local variables and labels it
+/// declares itself and doesn't leave the surrounding function or loop.
+bool isSelfContained(const Statement &s, const std::set<NameID> &declared,
+                     bool inLoop) {
+  typedef Statement::Kind Kind;
+  switch (s.getKind()) {
+  case Kind::Return:
+    return false;
+  case Kind::Break:
+  case Kind::Continue:
+    if (!inLoop)
+      return false;
+    break;
+  case Kind::LocalVarRef:
+    if (declared.count(s.getReferencedVarID()) == 0)
+      return false;
+    break;
+  case Kind::Goto:
+    if (declared.count(s.getGotoLabelID()) == 0)
+      return false;
+    break;
+  default:
+    break;
+  }
+  const bool childrenInLoop = inLoop || s.getKind() == Kind::While;
+  for (const Statement &child : s)
+    if (!isSelfContained(child, declared, childrenInLoop))
+      return false;
+  return true;
+}
+
+/// Returns all functions that have a body and aren't main.
+std::vector<const Function *> getTransplantableFunctions(const Program &p) {
+  std::vector<const Function *> res;
+  for (const Decl *d : p.getDeclList()) {
+    if (d->getKind() != Decl::Kind::Function)
+      continue;
+    const Function *f = static_cast<const Function *>(d);
+    if (!f->isExternal() && !f->isMain(p))
+      res.push_back(f);
+  }
+  return res;
+}
+} // namespace
+
+NameID Crossover::mapID(NameID id) {
+  auto found = idMap.find(id);
+  if (found != idMap.end())
+    return found->second;
+
+  const IdentTable &srcIdents = src.getIdents();
+  const std::string &name = srcIdents.getName(id);
+  NameID res = InvalidName;
+  if (srcIdents.isFixedID(id))
+    res = dst.getIdents().getOrCreateID(name, /*fixed=*/true);
+  else
+    res = dst.getIdents().makeNewID(getNamePrefix(name));
+  idMap[id] = res;
+
+  // Referencing a declaration means we need it in the destination too.
+  if (const Decl *d = findDecl(src, id))
+    transplantDecl(*d);
+  return res;
+}
+
+TypeRef Crossover::mapBasicType(const Type &t) {
+  const std::string &name = src.getIdents().getName(t.getNameID());
+  IdentTable &idents = dst.getIdents();
+  for (const Type &other : dst.getTypes())
+    if (other.getKind() == Type::Kind::Basic &&
+        idents.getName(other.getNameID()) == name)
+      return other.getRef();
+
+  Type res(idents.getOrCreateID(name, /*fixed=*/true),
+           t.hasSize() ? t.getByteSize() : 0);
+  res.setIsSigned(t.isSigned());
+  return dst.getTypes().addType(res);
+}
+
+TypeRef Crossover::mapFunctionPointer(const Type &t) {
+  const TypeRef ret = mapType(t.getFuncReturnType());
+  std::vector<TypeRef> args;
+  for (TypeRef arg : t.getArgs())
+    args.push_back(mapType(arg));
+
+  for (const Type &other : dst.getTypes())
+    if (other.getKind() == Type::Kind::FunctionPointer &&
+        other.getFuncReturnType() == ret && other.getArgs() == args)
+      return other.getRef();
+  return dst.getTypes().addType(
+      Type::FunctionPointer(ret, args, mapID(t.getNameID())));
+}
+
+TypeRef Crossover::mapType(TypeRef t) {
+  if (t == Void())
+    return t;
+  auto found = typeMap.find(t);
+  if (found != typeMap.end())
+    return found->second;
+
+  const Type &srcType = src.getTypes().get(t);
+  TypeTable &types = dst.getTypes();
+  TypeRef res = Void();
+  switch (srcType.getKind()) {
+  case Type::Kind::Basic:
+    res = mapBasicType(srcType);
+    break;
+  case Type::Kind::Pointer:
+  case Type::Kind::Const:
+  case Type::Kind::Volatile:
+    res = types.getOrCreateDerived(dst.getIdents(), srcType.getKind(),
+                                   mapType(srcType.getBase()));
+    break;
+  case Type::Kind::Array:
+    res = types.getOrCreateArray(dst.getIdents(), mapType(srcType.getBase()),
+                                 srcType.getArraySize());
+    break;
+  case Type::Kind::FunctionPointer:
+    res = mapFunctionPointer(srcType);
+    break;
+  case Type::Kind::Record: {
+    // Mapping the name copies the record declaration which creates the type.
+    const NameID record = mapID(srcType.getRecordNameID());
+    std::optional<TypeRef> recordType = types.getTypeForRecord(record);
+    SCCAssert(recordType, "Record wasn't transplanted?");
+    res = *recordType;
+    break;
+  }
+  case Type::Kind::Invalid:
+    SCCError("Invalid type in source program?");
+  }
+  typeMap[t] = res;
+  return res;
+}
+
+Statement Crossover::remap(Statement s) {
+  s.remap([this](NameID id) { return mapID(id); },
+          [this](TypeRef t) { return mapType(t); });
+  // Extra data refers to the identifiers of the source program.
+  s.modifyEachChild([](Statement &child) {
+    child.removeExtraData();
+    return LoopCtrl::Continue;
+  });
+  return s;
+}
+
+Decl &Crossover::transplantFunction(const Function &f, NameID name) {
+  std::vector<Variable> args;
+  for (const Variable &arg : f.getArgs())
+    args.emplace_back(mapType(arg.getType()), mapID(arg.getName()));
+  auto copy = std::make_unique<Function>(
+      mapType(f.getReturnType()), name, args,
+      f.isVariadic() ? Function::Variadic::Yes : Function::Variadic::No);
+  copy->isStatic = f.isStatic;
+  copy->isNoExcept = f.isNoExcept;
+  copy->setCallingConv(f.callingConv);
+  copy->setWeight(f.weight);
+  copy->setExternalHeader(f.getExternalHeader());
+  for (const std::string &attr : f.getAllAttrs())
+    copy->addAttr(attr);
+
+  // Add the function before remapping the body so that recursive calls find
+  // it.
+  Function &res = dst.add(std::move(copy));
+  res.setBody(remap(f.getBody()));
+  return res;
+}
+
+Decl &Crossover::transplantGlobal(const GlobalVar &g, NameID name) {
+  auto copy =
+      std::make_unique<GlobalVar>(mapType(g.getAsVar().getType()), name);
+  copy->is_static = g.is_static;
+  GlobalVar &res = dst.add(std::move(copy));
+  res.setInit(remap(g.getInit()));
+  return res;
+}
+
+Decl &Crossover::transplantRecord(const Record &r, NameID name) {
+  std::unique_ptr<Record> copy = r.isUnion()
+                                     ? Record::Union(dst, name)
+                                     : std::make_unique<Record>(
+                                           dst, name, r.isPacked());
+  // Register the type first as fields might point to the record itself.
+  typeMap[r.getType()] = copy->getType();
+  Record &res = dst.add(std::move(copy));
+  for (const Record::Field &f : r.getFields()) {
+    Record::Field field(mapID(f.getName()), mapType(f.getType()),
+                        f.getBitfieldSize());
+    field.setAlignment(f.getMinAlignment());
+    res.addField(field);
+  }
+  return res;
+}
+
+Decl &Crossover::transplantDecl(const Decl &d) {
+  const NameID name = mapID(static_cast<const NamedDecl &>(d).getNameID());
+  // Already copied (or a fixed declaration like main).
+  if (Decl *existing = findDecl(dst, name))
+    return *existing;
+
+  switch (d.getKind()) {
+  case Decl::Kind::Function:
+    return transplantFunction(static_cast<const Function &>(d), name);
+  case Decl::Kind::GlobalVar:
+    return transplantGlobal(static_cast<const GlobalVar &>(d), name);
+  case Decl::Kind::Record:
+    return transplantRecord(static_cast<const Record &>(d), name);
+  }
+  SCCError("Unknown declaration kind");
+}
+
+Maybe<Statement> Crossover::transplantStatement(const Statement &s) {
+  if (s.isExpr())
+    return Err("Can only transplant statements");
+
+  std::set<NameID> declared;
+  s.foreachChild([&declared](const Statement &c) {
+    if (c.getKind() == Statement::Kind::GotoLabel)
+      declared.insert(c.getJumpTarget());
+    else if (c.declaresVariable() || c.getKind() == Statement::Kind::Catch)
+      declared.insert(c.getDeclaredVarID());
+    return LoopCtrl::Continue;
+  });
+  if (!isSelfContained(s, declared, /*inLoop=*/false))
+    return Err("Statement depends on its surrounding function");
+  return remap(s);
+}
+
+OptError Crossover::crossover(Program &dst, const Program &src, Rng &rng) {
+  Crossover c(dst, src);
+  switch (rng.pickIndex(3)) {
+  case 0: {
+    std::vector<const Function *> funcs = getTransplantableFunctions(src);
+    if (funcs.empty())
+      return Err("No function to transplant");
+    c.transplantDecl(*rng.pickOneVec(funcs));
+    break;
+  }
+  case 1: {
+    std::vector<const Decl *> globals;
+    for (const Decl *d : src.getDeclList())
+      if (d->getKind() == Decl::Kind::GlobalVar)
+        globals.push_back(d);
+    if (globals.empty())
+      return Err("No global variable to transplant");
+    c.transplantDecl(*rng.pickOneVec(globals));
+    break;
+  }
+  default: {
+    std::vector<const Statement *> stmts;
+    for (const Function *f : getTransplantableFunctions(src))
+      for (const Statement::StmtAndParent &s : f->getBody().getAllChildren())
+        if (s.parent->getKind() == Statement::Kind::Compound)
+          stmts.push_back(s.stmt);
+    if (stmts.empty())
+      return Err("No statement to transplant");
+    Maybe<Statement> copy = c.transplantStatement(*rng.pickOneVec(stmts));
+    if (copy.isErr())
+      return copy.takeError();
+
+    // Insert the copy into a random compound statement of the destination.
+    std::vector<Statement *> compounds;
+    for (Decl *d : dst.getDeclList()) {
+      if (d->getKind() != Decl::Kind::Function)
+        continue;
+      Function *f = static_cast<Function *>(d);
+      if (f->isExternal())
+        continue;
+      f->getBody().modifyEachChild([&compounds](Statement &s) {
+        if (s.getKind() == Statement::Kind::Compound)
+          compounds.push_back(&s);
+        return LoopCtrl::Continue;
+      });
+    }
+    if (compounds.empty())
+      return Err("No place to insert the statement");
+    Statement &target = *rng.pickOneVec(compounds);
+    std::vector<Statement> children(target.begin(), target.end());
+    children.insert(children.begin() + rng.getBelow(children.size()), *copy);
+    target = Statement::CompoundStmt(children);
+    break;
+  }
+  }
+  dst.verifySelf();
+  return {};
+}
@@ -0,0 +1,68 @@
+#include "scc/mutator-utils/FeatureMap.h"
+
+#include <array>
+
+namespace {
+/// Maps a hit count to its bucket (0 for counters that were never hit).
+constexpr std::array<uint8_t, 256> makeBucketTable() {
+  std::array<uint8_t, 256> res = {};
+  for (unsigned i = 1; i < res.size(); ++i) {
+    if (i <= 3)
+      res[i] = i;
+    else if (i < 8)
+      res[i] = 4;
+    else if (i < 16)
+      res[i] = 5;
+    else if (i < 32)
+      res[i] = 6;
+    else if (i < 128)
+      res[i] = 7;
+    else
+      res[i] = 8;
+  }
+  return res;
+}
+constexpr std::array<uint8_t, 256> bucketTable = makeBucketTable();
+} // namespace
+
+std::vector<uint32_t> FeatureMap::collectFeatures(const uint8_t *counters,
+                                                  size_t size) {
+  std::vector<uint32_t> res;
+  for (size_t i = 0; i < size; ++i) {
+    const uint8_t bucket = bucketTable[counters[i]];
+    if (bucket != 0)
+      res.push_back(i * bucketsPerCounter + bucket - 1);
+  }
+  return res;
+}
+
+size_t FeatureMap::addFeatures(const std::vector<uint32_t> &features) {
+  size_t res = 0;
+  for (uint32_t feature : features) {
+    if (feature >= seen.size())
+      seen.resize(feature + 1);
+    if (seen[feature])
+      continue;
+    seen[feature] = true;
+    ++res;
+  }
+  numFeatures += res;
+  return res;
+}
+
+void FeatureMap::save(BinaryWriter &w) const {
+  w.writeUInt(numFeatures);
+  for (size_t i = 0; i < seen.size(); ++i)
+    if (seen[i])
+      w.writeUInt(i);
+}
+
+void FeatureMap::load(BinaryReader &r) {
+  seen.clear();
+  numFeatures = 0;
+  const size_t size = r.readSize();
+  std::vector<uint32_t> features;
+  for (size_t i = 0; i < size && !r.hasFailed(); ++i)
+    features.push_back(r.readUInt());
+  addFeatures(features);
+}
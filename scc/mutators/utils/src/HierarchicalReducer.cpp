@@ -0,0 +1,402 @@
+#include "scc/mutator-utils/HierarchicalReducer.h"
+
+#include "scc/mutator-utils/TypeGarbageCollector.h"
+
+#include <algorithm>
+
+namespace {
+typedef HierarchicalReducer::NodePath NodePath;
+
+size_t getPrintedSize(const Program &p) {
+  CountingStream out;
+  p.print(out).assumeSuccess("Failed to print to calculate size");
+  return out.getSize();
+}
+
+/// Returns the function with a body at the given declaration index or null.
+const Function *getFunctionWithBody(const Program &p, size_t declIndex) {
+  const Decl *d = p.getDeclList().at(declIndex);
+  if (d->getKind() != Decl::Kind::Function)
+    return nullptr;
+  const Function *f = static_cast<const Function *>(d);
+  if (f->isExternal())
+    return nullptr;
+  return f;
+}
+
+Statement &resolve(Program &p, const NodePath &path) {
+  Decl *d = p.getDeclList().at(path.declIndex);
+  SCCAssert(d->getKind() == Decl::Kind::Function, "Path not in a function?");
+  Statement *s = &static_cast<Function *>(d)->getBody();
+  for (size_t child : path.children)
+    s = &s->getChildWithIndex(child);
+  return *s;
+}
+
+/// Calls `f` for every statement in every function body in preorder.
+void walkBodies(
+    const Program &p,
+    const std::function<void(const Statement &, const NodePath &,
+                             const Statement *parent)> &f) {
+  std::function<void(const Statement &, NodePath &, const Statement *)> walk =
+      [&](const Statement &s, NodePath &path, const Statement *parent) {
+        f(s, path, parent);
+        for (size_t i = 0; i < s.getNumChildren(); ++i) {
+          path.children.push_back(i);
+          walk(s.getChildren().at(i), path, &s);
+          path.children.pop_back();
+        }
+      };
+  const size_t numDecls = p.getDeclList().size();
+  for (size_t i = 0; i < numDecls; ++i) {
+    const Function *f = getFunctionWithBody(p, i);
+    if (!f)
+      continue;
+    NodePath path;
+    path.declIndex = i;
+    walk(f->getBody(), path, nullptr);
+  }
+}
+
+std::vector<NodePath> collectCompounds(const Program &p) {
+  std::vector<NodePath> res;
+  walkBodies(p, [&res](const Statement &s, const NodePath &path,
+                       const Statement *) {
+    if (s.getKind() == Statement::Kind::Compound)
+      res.push_back(path);
+  });
+  return res;
+}
+
+/// Returns true if the child at the given index of the parent can be replaced
+/// by a different expression of the same type.
+bool isReplaceable(const Statement &parent, size_t index) {
+  typedef Statement::Kind Kind;
+  switch (parent.getKind()) {
+  // These need an lvalue.
+  case Kind::Assign:
+  case Kind::Subscript:
+    return index != 0;
+  case Kind::AddrOf:
+  case Kind::Dot:
+  case Kind::Arrow:
+  // Would just create null-pointer dereferences.
+  case Kind::Deref:
+  case Kind::ArrayConstant:
+    return false;
+  case Kind::IndirectCall:
+    return index != 0;
+  default:
+    return true;
+  }
+}
+
+/// Returns the simpler expressions the given expression could be replaced
+/// with.
+std::vector<Statement> getReplacements(const Program &p, const Statement &e) {
+  std::vector<Statement> res;
+  if (e.getKind() == Statement::Kind::Constant)
+    return res;
+  const TypeRef t = e.getEvalType();
+  if (t == Void())
+    return res;
+  const Type &type = p.getTypes().getUnqualified(t);
+  if (type.getKind() == Type::Kind::Basic || type.isPointer())
+    res.push_back(Statement::Constant("0", t));
+  for (const Statement &child : e)
+    if (child.isExpr() && child.getEvalType() == t)
+      res.push_back(child);
+  return res;
+}
+
+std::vector<NodePath> collectExpressions(const Program &p) {
+  std::vector<NodePath> res;
+  walkBodies(p, [&res, &p](const Statement &s, const NodePath &path,
+                           const Statement *parent) {
+    if (!parent || !s.isExpr())
+      return;
+    if (!isReplaceable(*parent, path.children.back()))
+      return;
+    if (getReplacements(p, s).empty())
+      return;
+    res.push_back(path);
+  });
+  return res;
+}
+
+/// Collects the identifiers of variables and labels declared in `s`.
+void collectDeclaredIDs(const Statement &s, std::vector<NameID> &ids) {
+  s.foreachChild([&ids](const Statement &c) {
+    switch (c.getKind()) {
+    case Statement::Kind::VarDecl:
+    case Statement::Kind::VarDef:
+    case Statement::Kind::Catch:
+      ids.push_back(c.getDeclaredVarID());
+      break;
+    case Statement::Kind::GotoLabel:
+      ids.push_back(c.getJumpTarget());
+      break;
+    default:
+      break;
+    }
+    return LoopCtrl::Continue;
+  });
+}
+} // namespace
+
+HierarchicalReducer::HierarchicalReducer(FeedbackFunc feedback,
+                                         const Program &p)
+    : feedback(feedback), current(p), currentSize(getPrintedSize(p)) {
+  // The original program is already known to be interesting.
+  cache.isInCache(current);
+}
+
+HierarchicalReducer::Outcome
+HierarchicalReducer::tryCandidate(Program &&candidate) {
+  const ProgramCache::Digest digest = ProgramCache::digest(candidate);
+  if (!digest.printable) {
+    ++stats.skippedCandidates;
+    return Outcome::Skipped;
+  }
+  const size_t size = digest.size;
+  if (size >= currentSize || cache.isInCache(digest.hash)) {
+    ++stats.skippedCandidates;
+    return Outcome::Skipped;
+  }
+  ++stats.oracleCalls;
+  if (!feedback(candidate).interesting)
+    return Outcome::Rejected;
+  ++stats.acceptedCandidates;
+  current = std::move(candidate);
+  currentSize = size;
+  progressInRound = true;
+  return Outcome::Accepted;
+}
+
+std::pair<size_t, size_t>
+HierarchicalReducer::getChunk(size_t listSize) const {
+  return {chunkIndex * listSize / chunks,
+          (chunkIndex + 1) * listSize / chunks};
+}
+
+bool HierarchicalReducer::advanceDDMin(Outcome o, size_t listSize) {
+  if (o == Outcome::Accepted) {
+    auto chunk = getChunk(listSize);
+    const size_t newSize = listSize - (chunk.second - chunk.first);
+    if (newSize == 0)
+      return true;
+    chunks = std::min(std::max<size_t>(chunks - 1, 2), newSize);
+    chunkIndex = 0;
+    return false;
+  }
+  ++chunkIndex;
+  if (chunkIndex < chunks)
+    return false;
+  // Tried every chunk at this granularity.
+  if (chunks >= listSize)
+    return true;
+  chunks = std::min(chunks * 2, listSize);
+  chunkIndex = 0;
+  return false;
+}
+
+void HierarchicalReducer::nextLevel() {
+  itemIndex = 0;
+  chunks = 0;
+  chunkIndex = 0;
+  replacementIndex = 0;
+  switch (level) {
+  case Level::Decls:
+    level = Level::Statements;
+    break;
+  case Level::Statements:
+    level = Level::Expressions;
+    break;
+  case Level::Expressions:
+    // Removing something in a later pass can enable more reductions in an
+    // earlier one, so repeat until nothing changes anymore.
+    level = progressInRound ? Level::Decls : Level::CollectTypes;
+    progressInRound = false;
+    break;
+  case Level::CollectTypes:
+  case Level::Done:
+    level = Level::Done;
+    break;
+  }
+}
+
+HierarchicalReducer::Outcome HierarchicalReducer::stepDecls() {
+  std::vector<size_t> removable;
+  const std::vector<Decl *> decls = current.getDeclList();
+  for (size_t i = 0; i < decls.size(); ++i) {
+    const Decl *d = decls.at(i);
+    if (d->getKind() == Decl::Kind::Function &&
+        static_cast<const Function *>(d)->isMain(current))
+      continue;
+    removable.push_back(i);
+  }
+  if (removable.empty()) {
+    nextLevel();
+    return Outcome::Skipped;
+  }
+
+  if (chunks == 0)
+    chunks = std::min<size_t>(2, removable.size());
+  const auto chunk = getChunk(removable.size());
+
+  Program candidate = current;
+  const std::vector<Decl *> candidateDecls = candidate.getDeclList();
+  std::vector<NameID> removedNames;
+  std::vector<TypeRef> removedRecords;
+  for (size_t i = chunk.first; i < chunk.second; ++i) {
+    Decl *d = candidateDecls.at(removable.at(i));
+    const NameID name = static_cast<const NamedDecl *>(d)->getNameID();
+    removedNames.push_back(name);
+    if (d->getKind() == Decl::Kind::Record)
+      if (auto t = candidate.getTypes().getTypeForRecord(name))
+        removedRecords.push_back(*t);
+    candidate.removeDecl(d);
+  }
+
+  // Don't bother the oracle with programs that reference removed decls.
+  bool dangling = false;
+  for (NameID name : removedNames)
+    dangling |= candidate.isIDUsed(name);
+  for (TypeRef t : removedRecords)
+    for (const Decl *d : candidate.getDeclList())
+      dangling |= d->usesType(t);
+
+  Outcome res = Outcome::Skipped;
+  if (dangling)
+    ++stats.skippedCandidates;
+  else
+    res = tryCandidate(std::move(candidate));
+
+  if (advanceDDMin(res, removable.size()))
+    nextLevel();
+  return res;
+}
+
+HierarchicalReducer::Outcome HierarchicalReducer::stepStatements() {
+  const std::vector<NodePath> compounds = collectCompounds(current);
+  if (itemIndex >= compounds.size()) {
+    nextLevel();
+    return Outcome::Skipped;
+  }
+  const NodePath &path = compounds.at(itemIndex);
+  const size_t numChildren = resolve(current, path).getNumChildren();
+
+  auto nextCompound = [this]() {
+    ++itemIndex;
+    chunks = 0;
+    chunkIndex = 0;
+  };
+  if (numChildren == 0) {
+    nextCompound();
+    return Outcome::Skipped;
+  }
+
+  if (chunks == 0)
+    chunks = std::min<size_t>(2, numChildren);
+  const auto chunk = getChunk(numChildren);
+
+  Program candidate = current;
+  Statement &compound = resolve(candidate, path);
+  std::vector<Statement> remaining;
+  std::vector<NameID> removedIDs;
+  for (size_t i = 0; i < numChildren; ++i) {
+    const Statement &child = compound.getChildren().at(i);
+    if (i >= chunk.first && i < chunk.second)
+      collectDeclaredIDs(child, removedIDs);
+    else
+      remaining.push_back(child);
+  }
+  compound = Statement::CompoundStmt(remaining);
+
+  // Don't bother the oracle with programs that use removed variables/labels.
+  bool dangling = false;
+  for (NameID id : removedIDs)
+    dangling |= candidate.isIDUsed(id);
+
+  Outcome res = Outcome::Skipped;
+  if (dangling)
+    ++stats.skippedCandidates;
+  else
+    res = tryCandidate(std::move(candidate));
+
+  if (advanceDDMin(res, numChildren))
+    nextCompound();
+  return res;
+}
+
+HierarchicalReducer::Outcome HierarchicalReducer::stepExpressions() {
+  const std::vector<NodePath> exprs = collectExpressions(current);
+  if (itemIndex >= exprs.size()) {
+    nextLevel();
+    return Outcome::Skipped;
+  }
+  const NodePath &path = exprs.at(itemIndex);
+  const std::vector<Statement> replacements =
+      getReplacements(current, resolve(current, path));
+  if (replacementIndex >= replacements.size()) {
+    ++itemIndex;
+    replacementIndex = 0;
+    return Outcome::Skipped;
+  }
+
+  Program candidate = current;
+  resolve(candidate, path) = replacements.at(replacementIndex);
+  const Outcome res = tryCandidate(std::move(candidate));
+  // On success try to simplify the new expression at the same position.
+  if (res == Outcome::Accepted)
+    replacementIndex = 0;
+  else
+    ++replacementIndex;
+  return res;
+}
+
+HierarchicalReducer::Outcome HierarchicalReducer::stepCollectTypes() {
+  nextLevel();
+  Program candidate = current;
+  TypeGarbageCollector(candidate).run();
+  // Unused types usually aren't printed at all, so there is nothing to check.
+  if (getPrintedSize(candidate) == currentSize) {
+    current = std::move(candidate);
+    return Outcome::Skipped;
+  }
+  return tryCandidate(std::move(candidate));
+}
+
+std::string HierarchicalReducer::step() {
+  while (!finished()) {
+    Outcome o = Outcome::Skipped;
+    std::string pass;
+    switch (level) {
+    case Level::Decls:
+      o = stepDecls();
+      pass = "declarations";
+      break;
+    case Level::Statements:
+      o = stepStatements();
+      pass = "statements";
+      break;
+    case Level::Expressions:
+      o = stepExpressions();
+      pass = "expressions";
+      break;
+    case Level::CollectTypes:
+      o = stepCollectTypes();
+      pass = "types";
+      break;
+    case Level::Done:
+      break;
+    }
+    if (o != Outcome::Skipped)
+      return "Reducing " + pass + " (Oracle calls: " +
+             std::to_string(stats.oracleCalls) +
+             ", skipped: " + std::to_string(stats.skippedCandidates) + ")";
+  }
+  return "Done with hierarchical reduction (Oracle calls: " +
+         std::to_string(stats.oracleCalls) +
+         ", skipped: " + std::to_string(stats.skippedCandidates) + ")";
+}
@@ -0,0 +1,113 @@
+#include "scc/mutator-utils/IslandScheduler.h"
+
+#include <array>
+
+namespace {
+struct TopologyName {
+  MigrationTopology topology;
+  const char *name;
+};
+
+constexpr std::array<TopologyName, 2> topologyNames = {{
+    {MigrationTopology::Ring, "ring"},
+    {MigrationTopology::Random, "random"},
+}};
+} // namespace
+
+Maybe<MigrationTopology> parseMigrationTopology(const std::string &name) {
+  for (const TopologyName &t : topologyNames)
+    if (name == t.name)
+      return t.topology;
+  std::string known;
+  for (const TopologyName &t : topologyNames)
+    known += std::string(known.empty() ? "" : ", ") + t.name;
+  return Err("Unknown migration topology '" + name + "'. Known: " + known);
+}
+
+std::string getMigrationTopologyName(MigrationTopology t) {
+  for (const TopologyName &n : topologyNames)
+    if (n.topology == t)
+      return n.name;
+  SCCError("Unknown migration topology");
+}
+
+size_t pickMigrationTarget(MigrationTopology t, size_t from, size_t islands,
+                           Rng &rng) {
+  SCCAssert(islands > 1, "Migration needs at least two islands");
+  if (t == MigrationTopology::Ring)
+    return (from + 1) % islands;
+  // Pick from all other islands.
+  const size_t target = rng.pickIndex(islands - 1);
+  return target >= from ? target + 1 : target;
+}
+
+IslandSchedulerBase::IslandSchedulerBase(size_t islands) {
+  for (size_t i = 0; i < islands; ++i)
+    mailboxes.push_back(std::make_unique<Mailbox>());
+}
+
+void IslandSchedulerBase::sendMigrants(size_t from,
+                                       std::vector<Program> programs,
+                                       Rng &rng) {
+  if (mailboxes.size() < 2 || programs.empty())
+    return;
+  const size_t sent = programs.size();
+  Mailbox &target = *mailboxes.at(
+      pickMigrationTarget(topology, from, mailboxes.size(), rng));
+  {
+    std::lock_guard<std::mutex> lock(target.mutex);
+    for (Program &p : programs)
+      target.migrants.push_back(std::move(p));
+  }
+  Mailbox &source = *mailboxes.at(from);
+  std::lock_guard<std::mutex> lock(source.mutex);
+  source.stats.migrantsSent += sent;
+}
+
+std::vector<Program> IslandSchedulerBase::takeMigrants(size_t island) {
+  Mailbox &box = *mailboxes.at(island);
+  std::lock_guard<std::mutex> lock(box.mutex);
+  std::vector<Program> res = std::move(box.migrants);
+  box.migrants.clear();
+  box.stats.migrantsReceived += res.size();
+  return res;
+}
+
+std::vector<Program> IslandSchedulerBase::takeFindings(size_t island) {
+  Mailbox &box = *mailboxes.at(island);
+  std::lock_guard<std::mutex> lock(box.mutex);
+  std::vector<Program> res = std::move(box.findings);
+  box.findings.clear();
+  return res;
+}
+
+std::vector<std::string> IslandSchedulerBase::takeErrors(size_t island) {
+  Mailbox &box = *mailboxes.at(island);
+  std::lock_guard<std::mutex> lock(box.mutex);
+  std::vector<std::string> res = std::move(box.errors);
+  box.errors.clear();
+  return res;
+}
+
+void IslandSchedulerBase::publish(size_t island, IslandStats stats,
+                                  std::vector<Program> findings,
+                                  std::vector<std::string> errors) {
+  Mailbox &box = *mailboxes.at(island);
+  std::lock_guard<std::mutex> lock(box.mutex);
+  stats.migrantsSent = box.stats.migrantsSent;
+  stats.migrantsReceived = box.stats.migrantsReceived;
+  box.stats = stats;
+  for (Program &p : findings)
+    box.findings.push_back(std::move(p));
+  for (std::string &err : errors)
+    box.errors.push_back(std::move(err));
+}
+
+std::vector<IslandStats> IslandSchedulerBase::getIslandStats() const {
+  std::vector<IslandStats> res;
+  for (const std::unique_ptr<Mailbox> &box : mailboxes) {
+    std::lock_guard<std::mutex> lock(box->mutex);
+    res.push_back(box->stats);
+  }
+  return res;
+}
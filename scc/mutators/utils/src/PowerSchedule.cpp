@@ -0,0 +1,112 @@
+#include "scc/mutator-utils/PowerSchedule.h"
+
+#include <algorithm>
+
+namespace {
+struct ScheduleName {
+  PowerSchedule schedule;
+  const char *name;
+};
+
+constexpr std::array<ScheduleName, 5> scheduleNames = {{
+    {PowerSchedule::Fixed, "fixed"},
+    {PowerSchedule::Exploit, "exploit"},
+    {PowerSchedule::Explore, "explore"},
+    {PowerSchedule::Fast, "fast"},
+    {PowerSchedule::Coe, "coe"},
+}};
+
+/// The energy of an average entry.
+constexpr double baseEnergy = 16;
+
+/// AFL-style performance factor: Rewards entries that score high, are small,
+/// were only recently added and hit many coverage features.
+double performanceFactor(const QueueEntryStats &e) {
+  double factor = 1;
+
+  // Score rank (relative to the queue size).
+  const double rankPercentile =
+      e.rank / (double)std::max<size_t>(1, e.queueSize);
+  if (rankPercentile < 0.1)
+    factor *= 4;
+  else if (rankPercentile < 0.25)
+    factor *= 2;
+  else if (rankPercentile >= 0.75)
+    factor *= 0.25;
+  else if (rankPercentile >= 0.5)
+    factor *= 0.5;
+
+  // Program size.
+  if (e.averageNodes != 0) {
+    if (e.nodes * 2 < e.averageNodes)
+      factor *= 2;
+    else if (e.nodes > e.averageNodes * 2)
+      factor *= 0.5;
+  }
+
+  // Age.
+  if (e.averageAge != 0) {
+    if (e.age * 2 < e.averageAge)
+      factor *= 2;
+    else if (e.age > e.averageAge * 2)
+      factor *= 0.75;
+  }
+
+  // Coverage (only if the oracle reports features).
+  if (e.averageFeatures != 0) {
+    if (e.features > e.averageFeatures + e.averageFeatures / 4)
+      factor *= 2;
+    else if (e.features * 2 < e.averageFeatures)
+      factor *= 0.5;
+  }
+  return factor;
+}
+
+/// The 'fast' factor from AFLFast: Grows exponentially with the number of
+/// picks, shrinks with the number of mutations that led nowhere.
+double fastFactor(const QueueEntryStats &e) {
+  const double picksFactor = 1ULL << std::min<size_t>(e.picks, 16);
+  const double fruitless = 1 + e.fruitlessRuns / baseEnergy;
+  return picksFactor / fruitless;
+}
+} // namespace
+
+Maybe<PowerSchedule> parsePowerSchedule(const std::string &name) {
+  for (const ScheduleName &s : scheduleNames)
+    if (name == s.name)
+      return s.schedule;
+  std::string known;
+  for (const ScheduleName &s : scheduleNames)
+    known += std::string(known.empty() ? "" : ", ") + s.name;
+  return Err("Unknown power schedule '" + name + "'. Known: " + known);
+}
+
+std::string getPowerScheduleName(PowerSchedule s) {
+  for (const ScheduleName &n : scheduleNames)
+    if (n.schedule == s)
+      return n.name;
+  SCCError("Unknown power schedule");
+}
+
+size_t computeEnergy(PowerSchedule s, const QueueEntryStats &e,
+                     size_t maxEnergy) {
+  double energy = baseEnergy * performanceFactor(e);
+  switch (s) {
+  case PowerSchedule::Fixed:
+    return maxEnergy;
+  case PowerSchedule::Exploit:
+    break;
+  case PowerSchedule::Explore:
+    energy /= 4;
+    break;
+  case PowerSchedule::Fast:
+    energy *= fastFactor(e);
+    break;
+  case PowerSchedule::Coe:
+    if (e.picks > 0 && e.fruitlessRuns > e.averageFruitlessRuns)
+      return 0;
+    energy *= fastFactor(e);
+    break;
+  }
+  return std::clamp<size_t>((size_t)energy, 1, std::max<size_t>(1, maxEnergy));
+}
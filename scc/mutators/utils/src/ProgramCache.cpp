@@ -1 +1,20 @@
 #include "scc/mutator-utils/ProgramCache.h"
+
+void ProgramCache::save(BinaryWriter &w) const {
+  std::lock_guard<std::mutex> lock(mutex);
+  w.writeUInt(queries);
+  w.writeUInt(hashHits);
+  w.writeUInt(seenHashes.size());
+  for (HashStream::Hash hash : seenHashes)
+    w.writeUInt(hash);
+}
+
+void ProgramCache::load(BinaryReader &r) {
+  std::lock_guard<std::mutex> lock(mutex);
+  queries = r.readUInt();
+  hashHits = r.readUInt();
+  seenHashes.clear();
+  const size_t size = r.readSize();
+  for (size_t i = 0; i < size && !r.hasFailed(); ++i)
+    seenHashes.insert(r.readUInt());
+}
@@ -0,0 +1,88 @@
+#include "scc/mutator-utils/ProgramLineage.h"
+
+#include <vector>
+
+ProgramLineage::Ref ProgramLineage::makeKeyframe(const Program &p) {
+  auto res = std::make_shared<ProgramLineage>();
+  res->keyframe = std::make_shared<const Program>(p);
+  res->hash = hashProgram(p);
+  return res;
+}
+
+ProgramLineage::Ref ProgramLineage::makeChild(Ref parent, ReplayFunc replay,
+                                              const Program &p,
+                                              size_t maxReplayDepth) {
+  if (!parent || parent->replayDepth + 1 > maxReplayDepth)
+    return makeKeyframe(p);
+  auto res = std::make_shared<ProgramLineage>();
+  res->replayDepth = parent->replayDepth + 1;
+  res->parent = parent;
+  res->replay = replay;
+  res->hash = hashProgram(p);
+  return res;
+}
+
+HashStream::Hash ProgramLineage::hashProgram(const Program &p) {
+  HashStream s;
+  p.print(s).assumeSuccess("Failed to print program in hash");
+  return s.getHash();
+}
+
+std::shared_ptr<const Program>
+MaterializedPrograms::lookup(const ProgramLineage::Ref &l) {
+  if (l->keyframe)
+    return l->keyframe;
+  for (auto it = entries.begin(); it != entries.end(); ++it) {
+    if (it->first != l)
+      continue;
+    // Move to the front as this is now the most recently used.
+    entries.splice(entries.begin(), entries, it);
+    return entries.front().second;
+  }
+  return nullptr;
+}
+
+std::shared_ptr<const Program>
+MaterializedPrograms::get(const ProgramLineage::Ref &l) {
+  SCCAssert(l, "Materializing null lineage?");
+  if (auto cached = lookup(l))
+    return cached;
+
+  // Walk up to the closest ancestor we have a program for.
+  std::vector<const ProgramLineage *> toReplay;
+  std::shared_ptr<const Program> base;
+  for (ProgramLineage::Ref current = l; !base; current = current->parent) {
+    SCCAssert(current, "Lineage without keyframe?");
+    base = lookup(current);
+    if (!base)
+      toReplay.push_back(current.get());
+  }
+
+  // Replay the mutations from the oldest to the newest.
+  Program p = *base;
+  for (auto it = toReplay.rbegin(); it != toReplay.rend(); ++it) {
+    (*it)->replay(p);
+    ++replays;
+    SCCAssertEqual(ProgramLineage::hashProgram(p), (*it)->hash,
+                   "Replaying mutation yielded a different program?");
+  }
+  auto res = std::make_shared<const Program>(std::move(p));
+  insert(l, res);
+  return res;
+}
+
+void MaterializedPrograms::insert(const ProgramLineage::Ref &l,
+                                  std::shared_ptr<const Program> p) {
+  // Keyframes are always available, no need to cache them.
+  if (l->keyframe)
+    return;
+  entries.emplace_front(l, p);
+  while (entries.size() > capacity)
+    entries.pop_back();
+}
+
+void MaterializedPrograms::setCapacity(size_t c) {
+  capacity = std::max<size_t>(1, c);
+  while (entries.size() > capacity)
+    entries.pop_back();
+}
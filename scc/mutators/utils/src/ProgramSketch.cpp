@@ -0,0 +1,82 @@
+#include "scc/mutator-utils/ProgramSketch.h"
+
+#include "scc/program/Function.h"
+#include "scc/program/GlobalVar.h"
+
+#include <limits>
+
+namespace {
+constexpr uint64_t numStatementKinds =
+    static_cast<uint64_t>(Statement::Kind::Group) + 1;
+
+/// The parent kind used for the root statement of a declaration. Doesn't
+/// collide with statement kinds.
+uint64_t declParent(Decl::Kind k) {
+  return numStatementKinds + static_cast<uint64_t>(k);
+}
+
+/// The finalizer of SplitMix64. Turns similar inputs into unrelated hashes.
+uint64_t mix(uint64_t x) {
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+/// Collects the shingles of the given statement and its children.
+void addShingles(const Statement &s, uint64_t parent, uint64_t grandparent,
+                 std::vector<uint64_t> &shingles) {
+  const uint64_t kind = static_cast<uint64_t>(s.getKind());
+  shingles.push_back((grandparent << 32) | (parent << 16) | kind);
+  for (const Statement &child : s)
+    addShingles(child, kind, parent, shingles);
+}
+} // namespace
+
+ProgramSketch ProgramSketch::compute(const Program &p) {
+  std::vector<uint64_t> shingles;
+  // Shingles of declarations are tagged so they never equal statement ones.
+  const uint64_t declTag = uint64_t(1) << 63;
+  uint64_t previousDecl = 0;
+  for (const Decl *d : p.getDeclList()) {
+    const uint64_t kind = declParent(d->getKind());
+    shingles.push_back(declTag | (previousDecl << 16) | kind);
+    previousDecl = kind;
+    switch (d->getKind()) {
+    case Decl::Kind::Function: {
+      const Function *f = static_cast<const Function *>(d);
+      if (!f->isExternal())
+        addShingles(f->getBody(), kind, 0, shingles);
+      break;
+    }
+    case Decl::Kind::GlobalVar:
+      addShingles(static_cast<const GlobalVar *>(d)->getInit(), kind, 0,
+                  shingles);
+      break;
+    case Decl::Kind::Record:
+      break;
+    }
+  }
+
+  ProgramSketch res;
+  res.minHashes.assign(numHashes, std::numeric_limits<uint32_t>::max());
+  for (uint64_t shingle : shingles) {
+    const uint64_t h = mix(shingle);
+    // Derive every hash function from one hash of the shingle.
+    for (size_t i = 0; i < numHashes; ++i) {
+      const uint32_t v = static_cast<uint32_t>(mix(h + i) >> 32);
+      if (v < res.minHashes[i])
+        res.minHashes[i] = v;
+    }
+  }
+  return res;
+}
+
+double ProgramSketch::similarity(const ProgramSketch &o) const {
+  if (empty() || o.empty())
+    return 0;
+  size_t same = 0;
+  for (size_t i = 0; i < numHashes; ++i)
+    same += minHashes[i] == o.minHashes[i];
+  return static_cast<double>(same) / numHashes;
+}
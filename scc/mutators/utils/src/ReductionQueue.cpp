@@ -0,0 +1 @@
+#include "scc/mutator-utils/ReductionQueue.h"
@@ -0,0 +1,238 @@
+#include "scc/mutator-utils/ResultStore.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+/// 'SCCR' in little endian.
+constexpr uint32_t recordMagic = 0x52434353;
+
+enum RecordKind : uint16_t {
+  ResultRecord = 1,
+  StringRecord = 2,
+};
+
+enum ResultFlags : uint32_t {
+  Interesting = 1,
+  DeadEnd = 2,
+};
+
+struct RecordHeader {
+  uint32_t magic;
+  uint16_t kind;
+  uint16_t reserved;
+  uint32_t payloadSize;
+  uint32_t checksum;
+};
+
+/// Records of older versions, which were keyed by a weaker hash, have a
+/// different size and are ignored.
+struct ResultPayload {
+  uint64_t hash;
+  uint64_t size;
+  int64_t score;
+  uint64_t messageID;
+  uint64_t signatureID;
+  uint32_t flags;
+  uint32_t reserved;
+};
+
+/// Larger records are not appended. Bounds how far a damaged header can
+/// make us wait for a record that is still being appended.
+constexpr uint32_t maxPayloadSize = 1 << 20;
+
+/// The id of the empty string.
+constexpr uint64_t noString = 0;
+
+/// FNV-1a.
+uint64_t hashBytes(const char *data, size_t size) {
+  uint64_t res = 14695981039346656037ULL;
+  for (size_t i = 0; i < size; ++i) {
+    res ^= static_cast<unsigned char>(data[i]);
+    res *= 1099511628211ULL;
+  }
+  return res;
+}
+
+uint32_t checksum(const char *data, size_t size) {
+  const uint64_t h = hashBytes(data, size);
+  return static_cast<uint32_t>(h ^ (h >> 32));
+}
+
+/// Returns the offset of the next record magic after `pos`. If there is
+/// none, returns the offset of the last bytes that could be the start of a
+/// magic that is still being appended.
+size_t findNextRecord(const char *data, size_t pos, size_t size) {
+  const size_t magicSize = sizeof(recordMagic);
+  for (size_t i = pos + 1; i + magicSize <= size; ++i) {
+    uint32_t magic;
+    std::memcpy(&magic, data + i, magicSize);
+    if (magic == recordMagic)
+      return i;
+  }
+  return std::max(pos + 1, size - (magicSize - 1));
+}
+
+uint64_t getStringID(const std::string &s) {
+  if (s.empty())
+    return noString;
+  // Ids never collide with the empty string.
+  return hashBytes(s.data(), s.size()) | 1;
+}
+} // namespace
+
+Maybe<std::unique_ptr<ResultStore>> ResultStore::open(const std::string &path,
+                                                      size_t maxBytes) {
+  const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+  if (fd < 0)
+    return Err("Failed to open result store " + path + ": " +
+               std::strerror(errno));
+  std::unique_ptr<ResultStore> res(new ResultStore(fd, maxBytes));
+  res->scanNewRecords();
+  return res;
+}
+
+ResultStore::~ResultStore() { close(fd); }
+
+void ResultStore::scanNewRecords() {
+  struct stat st;
+  if (fstat(fd, &st) != 0)
+    return;
+  const size_t size = st.st_size;
+  if (size <= scannedBytes)
+    return;
+
+  // mmap offsets have to be page aligned.
+  const size_t pageSize = sysconf(_SC_PAGESIZE);
+  const size_t mapStart = scannedBytes - scannedBytes % pageSize;
+  void *mem =
+      mmap(nullptr, size - mapStart, PROT_READ, MAP_SHARED, fd, mapStart);
+  if (mem == MAP_FAILED)
+    return;
+  const char *data = static_cast<const char *>(mem) - mapStart;
+
+  size_t pos = scannedBytes;
+  while (pos + sizeof(RecordHeader) <= size) {
+    RecordHeader header;
+    std::memcpy(&header, data + pos, sizeof(header));
+    const char *payload = data + pos + sizeof(header);
+    const bool validHeader =
+        header.magic == recordMagic && header.payloadSize <= maxPayloadSize;
+    // Another process might still be appending this record.
+    if (validHeader && pos + sizeof(header) + header.payloadSize > size)
+      break;
+    // Skip what a crashed append left behind. The file is shared, so it
+    // can't be cut off.
+    if (!validHeader ||
+        checksum(payload, header.payloadSize) != header.checksum) {
+      pos = findNextRecord(data, pos, size);
+      continue;
+    }
+
+    if (header.kind == ResultRecord &&
+        header.payloadSize == sizeof(ResultPayload)) {
+      ResultPayload r;
+      std::memcpy(&r, payload, sizeof(r));
+      index[r.hash] = {r.size, r.score, r.messageID, r.signatureID, r.flags};
+    } else if (header.kind == StringRecord &&
+               header.payloadSize >= sizeof(uint64_t)) {
+      uint64_t id;
+      std::memcpy(&id, payload, sizeof(id));
+      strings[id] = std::string(payload + sizeof(id),
+                                header.payloadSize - sizeof(id));
+    }
+    pos += sizeof(header) + header.payloadSize;
+  }
+  munmap(mem, size - mapStart);
+  scannedBytes = pos;
+}
+
+void ResultStore::append(uint16_t kind, const std::string &payload) {
+  RecordHeader header = {};
+  header.magic = recordMagic;
+  header.kind = kind;
+  header.payloadSize = payload.size();
+  header.checksum = checksum(payload.data(), payload.size());
+
+  std::string record(reinterpret_cast<const char *>(&header), sizeof(header));
+  record += payload;
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 ||
+      static_cast<size_t>(st.st_size) + record.size() > maxBytes)
+    return;
+  // A single write so that concurrent writers don't interleave records.
+  if (write(fd, record.data(), record.size()) < 0)
+    return;
+}
+
+uint64_t ResultStore::storeString(const std::string &s) {
+  const uint64_t id = getStringID(s);
+  if (id == noString || strings.count(id))
+    return id;
+  // Huge strings are dropped instead of being stored in a record.
+  if (s.size() + sizeof(id) > maxPayloadSize)
+    return noString;
+  strings[id] = s;
+  std::string payload(reinterpret_cast<const char *>(&id), sizeof(id));
+  append(StringRecord, payload + s);
+  return id;
+}
+
+std::optional<ResultStore::Result> ResultStore::lookup(uint64_t hash,
+                                                       uint64_t size) {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto found = index.find(hash);
+  if (found == index.end()) {
+    // Maybe another process evaluated the program in the meantime.
+    scanNewRecords();
+    found = index.find(hash);
+    if (found == index.end())
+      return {};
+  }
+  // A hash collision with a different program.
+  if (found->second.size != size)
+    return {};
+  ++hits;
+  const Entry &e = found->second;
+  Result res;
+  res.score = e.score;
+  res.interesting = e.flags & Interesting;
+  res.deadEnd = e.flags & DeadEnd;
+  if (e.messageID != noString)
+    res.msg = strings[e.messageID];
+  if (e.signatureID != noString)
+    res.signature = strings[e.signatureID];
+  return res;
+}
+
+void ResultStore::store(uint64_t hash, uint64_t size, const Result &r) {
+  std::lock_guard<std::mutex> lock(mutex);
+  ResultPayload payload = {};
+  payload.hash = hash;
+  payload.size = size;
+  payload.score = r.score;
+  payload.messageID = storeString(r.msg);
+  payload.signatureID = storeString(r.signature);
+  payload.flags = (r.interesting ? static_cast<uint32_t>(Interesting) : 0) |
+                  (r.deadEnd ? static_cast<uint32_t>(DeadEnd) : 0);
+  index[hash] = {size, payload.score, payload.messageID, payload.signatureID,
+                 payload.flags};
+  const char *bytes = reinterpret_cast<const char *>(&payload);
+  append(ResultRecord, std::string(bytes, sizeof(payload)));
+}
+
+size_t ResultStore::getNumResults() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return index.size();
+}
+
+size_t ResultStore::getHits() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return hits;
+}
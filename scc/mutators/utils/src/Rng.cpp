@@ -1 +1,21 @@
 #include "scc/mutator-utils/Rng.h"
+
+#include <sstream>
+
+void RngSource::save(BinaryWriter &w) const {
+  std::stringstream state;
+  state << gen;
+  w.writeUInt(seed);
+  w.writeString(state.str());
+}
+
+void RngSource::load(BinaryReader &r) {
+  seed = r.readUInt();
+  std::stringstream state(r.readString());
+  std::ranlux48_base loaded;
+  if (!(state >> loaded)) {
+    r.fail("Malformed random generator state");
+    return;
+  }
+  gen = loaded;
+}
@@ -1 +1,351 @@
 #include "scc/mutator-utils/SchedulerBase.h"
+
+#include "scc/mutator-utils/SeedCorpus.h"
+#include "scc/program/ProgramSerializer.h"
+
+#include <future>
+#include <numeric>
+
+namespace {
+void saveFeedback(BinaryWriter &w, const SchedulerBase::Feedback &f) {
+  w.writeInt(f.score);
+  w.writeBool(f.interesting);
+  w.writeBool(f.deadEnd);
+  w.writeString(f.msg);
+  w.writeString(f.signature);
+  w.writeUInt(f.dictionary.size());
+  for (const std::string &entry : f.dictionary)
+    w.writeString(entry);
+  w.writeUInt(f.features.size());
+  for (uint32_t feature : f.features)
+    w.writeUInt(feature);
+}
+
+void loadFeedback(BinaryReader &r, SchedulerBase::Feedback &f) {
+  f.score = r.readInt();
+  f.interesting = r.readBool();
+  f.deadEnd = r.readBool();
+  f.msg = r.readString();
+  f.signature = r.readString();
+  const size_t numEntries = r.readSize();
+  for (size_t i = 0; i < numEntries && !r.hasFailed(); ++i)
+    f.dictionary.push_back(r.readString());
+  const size_t numFeatures = r.readSize();
+  for (size_t i = 0; i < numFeatures && !r.hasFailed(); ++i)
+    f.features.push_back(static_cast<uint32_t>(r.readUInt()));
+}
+
+Program readProgram(BinaryReader &r) {
+  Maybe<Program> p = ProgramSerializer::read(r);
+  if (p.isErr()) {
+    r.fail(p.getErrorMsg());
+    return Program();
+  }
+  return std::move(*p);
+}
+} // namespace
+
+void SchedulerBase::ClusterJob::save(BinaryWriter &w) const {
+  w.writeUInt(id);
+  ProgramSerializer::write(w, parent);
+  w.writeUInt(parentHash);
+  w.writeUInt(seed);
+  w.writeString(strategy);
+  w.writeUInt(scale);
+}
+
+void SchedulerBase::ClusterJob::load(BinaryReader &r) {
+  id = r.readUInt();
+  parent = readProgram(r);
+  parentHash = r.readUInt();
+  seed = r.readUInt();
+  strategy = r.readString();
+  scale = r.readUInt();
+}
+
+void SchedulerBase::ClusterResult::save(BinaryWriter &w) const {
+  w.writeUInt(jobId);
+  w.writeBool(rejected);
+  w.writeUInt(mutateMicros);
+  if (rejected)
+    return;
+  ProgramSerializer::write(w, mutant);
+  w.writeUInt(hash);
+  saveFeedback(w, feedback);
+  w.writeUInt(taken.size());
+  for (uint64_t decision : taken)
+    w.writeUInt(decision);
+  w.writeUInt(oracleMicros);
+}
+
+void SchedulerBase::ClusterResult::load(BinaryReader &r) {
+  jobId = r.readUInt();
+  rejected = r.readBool();
+  mutateMicros = r.readUInt();
+  if (rejected)
+    return;
+  mutant = readProgram(r);
+  hash = r.readUInt();
+  loadFeedback(r, feedback);
+  const size_t numTaken = r.readSize();
+  for (size_t i = 0; i < numTaken && !r.hasFailed(); ++i)
+    taken.push_back(r.readUInt());
+  oracleMicros = r.readUInt();
+}
+
+void SchedulerBase::saveBaseState(BinaryWriter &w) {
+  rng.save(w);
+  w.writeUInt(iterations);
+  w.writeUInt(nonCacheIterations);
+  w.writeUInt(numFindings);
+  w.writeUInt(desperation);
+  w.writeUInt(mutatorScale);
+  w.writeUInt(runsSinceProgress);
+  w.writeUInt(currentEntryId);
+  w.writeUInt(energyLeft);
+  w.writeUInt(nextEntryId);
+  w.writeUInt(novelPrograms);
+
+  w.writeUInt(queue.size());
+  for (const ProgAndMetadata &e : queue) {
+    // Lineages can't be stored, so compact entries are stored as the
+    // rebuilt program.
+    if (e.lineage)
+      ProgramSerializer::write(w, *getEntryProgram(e));
+    else
+      ProgramSerializer::write(w, e.p);
+    w.writeUInt(e.programNodes);
+    w.writeUInt(e.lengthGranularity);
+    w.writeString(e.feedbackMsg);
+    w.writeInt(e.score);
+    w.writeUInt(e.runs);
+    w.writeUInt(e.id);
+    w.writeUInt(e.queuedAt);
+    w.writeUInt(e.picks);
+    w.writeUInt(e.fruitlessRuns);
+    w.writeString(e.message);
+    w.writeUInt(e.features);
+    w.writeUInt(e.hash);
+  }
+
+  w.writeUInt(interestingResults.size());
+  for (const Program &p : interestingResults)
+    ProgramSerializer::write(w, p);
+
+  cache.save(w);
+  features.save(w);
+  signatures.save(w);
+  dictionary->save(w);
+  w.writeBool(surrogate != nullptr);
+  if (surrogate)
+    surrogate->save(w);
+}
+
+void SchedulerBase::loadBaseState(BinaryReader &r) {
+  rng.load(r);
+  iterations = r.readUInt();
+  nonCacheIterations = r.readUInt();
+  lastCheckpoint = nonCacheIterations;
+  numFindings = r.readUInt();
+  setDesperation(r.readUInt());
+  mutatorScale = r.readUInt();
+  runsSinceProgress = r.readUInt();
+  currentEntryId = r.readUInt();
+  energyLeft = r.readUInt();
+  nextEntryId = r.readUInt();
+  novelPrograms = r.readUInt();
+
+  queue.clear();
+  materialized.clear();
+  pinnedBestProg.reset();
+  const size_t queueSize = r.readSize();
+  for (size_t i = 0; i < queueSize && !r.hasFailed(); ++i) {
+    ProgAndMetadata e;
+    Program p = readProgram(r);
+    updateSketch(e, p);
+    if (compactQueue)
+      e.lineage = ProgramLineage::makeKeyframe(p);
+    else
+      e.setProgram(std::move(p));
+    e.programNodes = r.readUInt();
+    e.lengthGranularity = std::max<size_t>(1, r.readUInt());
+    e.feedbackMsg = r.readString();
+    e.score = r.readInt();
+    e.runs = r.readUInt();
+    e.id = r.readUInt();
+    e.queuedAt = r.readUInt();
+    e.picks = r.readUInt();
+    e.fruitlessRuns = r.readUInt();
+    e.message = r.readString();
+    e.features = r.readUInt();
+    e.hash = r.readUInt();
+    queue.push_back(std::move(e));
+  }
+  // The queue is rebuilt from scratch if the checkpoint didn't have one.
+  resetRequest = queue.empty();
+
+  interestingResults.clear();
+  const size_t numResults = r.readSize();
+  for (size_t i = 0; i < numResults && !r.hasFailed(); ++i)
+    interestingResults.push_back(readProgram(r));
+
+  cache.load(r);
+  features.load(r);
+  signatures.load(r);
+  auto loadedDict = std::make_shared<ConstantDictionary>();
+  loadedDict->setCapacity(dictionaryCapacity);
+  loadedDict->load(r);
+  dictionary = loadedDict;
+  if (r.readBool()) {
+    // The stored model is dropped if the surrogate model is now disabled.
+    SurrogateModel unused;
+    (surrogate ? *surrogate : unused).load(r);
+  }
+}
+
+OptError SchedulerBase::loadSeedCorpus(const std::string &dir,
+                                       size_t maxSeeds) {
+  Maybe<std::vector<Program>> loaded = SeedCorpus::load(dir, maxSeeds);
+  if (loaded.isErr())
+    return loaded.takeError();
+  if (loaded->empty())
+    return Err("No programs in seed corpus " + dir);
+  pendingSeeds = std::move(*loaded);
+  seeds.clear();
+  return {};
+}
+
+void SchedulerBase::evaluateSeeds() {
+  if (pendingSeeds.empty())
+    return;
+  const FeedbackFunc f = getEvalFunc();
+  std::vector<Feedback> results(pendingSeeds.size());
+  if (reducerPool) {
+    std::vector<std::future<void>> done;
+    for (size_t i = 0; i < pendingSeeds.size(); ++i)
+      done.push_back(reducerPool->submit(
+          [&f, &results, this, i]() { results[i] = f(pendingSeeds[i]); }));
+    for (std::future<void> &d : done)
+      d.get();
+  } else {
+    for (size_t i = 0; i < pendingSeeds.size(); ++i)
+      results[i] = f(pendingSeeds[i]);
+  }
+
+  for (size_t i = 0; i < pendingSeeds.size(); ++i) {
+    const Feedback &res = results[i];
+    updateDictionary(res);
+    features.addFeatures(res.features);
+    // Every mutant of such a seed would be a duplicate finding or a dead end.
+    if (res.interesting || res.deadEnd)
+      continue;
+    ProgAndMetadata e = makeEntry(std::move(pendingSeeds[i]));
+    e.score = res.score;
+    e.message = res.msg;
+    e.features = res.features.size();
+    seeds.push_back(std::move(e));
+  }
+  pendingSeeds.clear();
+}
+
+bool SchedulerBase::addSeeds(size_t n) {
+  if (seeds.empty())
+    return false;
+  std::vector<size_t> picked(seeds.size());
+  std::iota(picked.begin(), picked.end(), 0);
+  rng.shuffle(picked);
+  picked.resize(std::min(n, picked.size()));
+  for (size_t i : picked)
+    enqueue(ProgAndMetadata(seeds.at(i)));
+  return true;
+}
+
+OptError SchedulerBase::setCorpusSync(const std::string &dir,
+                                      const std::string &name, bool primary,
+                                      size_t every, size_t importBudget) {
+  auto sync = std::make_unique<CorpusSync>(dir, name, primary);
+  if (OptError err = sync->init())
+    return err;
+  corpusSync = std::move(sync);
+  syncEvery = std::max<size_t>(1, every);
+  syncImportBudget = importBudget;
+  return {};
+}
+
+void SchedulerBase::maybeSyncCorpus() {
+  if (!corpusSync || queue.empty())
+    return;
+  if (nonCacheIterations - lastSync < syncEvery)
+    return;
+  lastSync = nonCacheIterations;
+
+  const ProgAndMetadata &best = queue.back();
+  if (best.score > lastExportedScore) {
+    lastExportedScore = best.score;
+    // Other instances just don't see this program.
+    if (OptError err =
+            corpusSync->exportProgram(*getEntryProgram(best), best.hash))
+      addError("Failed to export program: " + err->getMessage());
+  }
+
+  importPrograms(corpusSync->importNew(syncImportBudget));
+}
+
+std::vector<Program> SchedulerBase::getBestPrograms(size_t n) {
+  std::vector<Program> res;
+  for (auto e = queue.rbegin(); e != queue.rend() && res.size() < n; ++e)
+    res.push_back(*getEntryProgram(*e));
+  return res;
+}
+
+void SchedulerBase::importPrograms(std::vector<Program> programs) {
+  for (Program &p : programs) {
+    const ProgramCache::Digest digest = ProgramCache::digest(p);
+    if (!digest.printable || cache.isInCache(digest.hash))
+      continue;
+    const Feedback res = evaluate(p, digest);
+    updateDictionary(res);
+    features.addFeatures(res.features);
+    // Findings are reported by the instance that found them.
+    if (res.interesting || res.deadEnd)
+      continue;
+    ProgAndMetadata e = makeEntry(std::move(p));
+    e.score = res.score;
+    e.message = res.msg;
+    e.features = res.features.size();
+    enqueue(std::move(e));
+  }
+  sortQueue();
+}
+
+void SchedulerBase::countSimilarEntries() {
+  for (ProgAndMetadata &e : queue)
+    e.similarEntries = 0;
+  for (auto l = queue.begin(); l != queue.end(); ++l) {
+    for (auto r = std::next(l); r != queue.end(); ++r) {
+      if (l->sketch.similarity(r->sketch) < similarityThreshold)
+        continue;
+      ++l->similarEntries;
+      ++r->similarEntries;
+    }
+  }
+}
+
+void SchedulerBase::evictSimilarEntries() {
+  // Walk from the best to the worst entry, so the best entry of a group of
+  // similar entries is always kept.
+  std::vector<const ProgramSketch *> kept;
+  for (auto e = queue.rbegin(); e != queue.rend();) {
+    size_t similar = 0;
+    for (const ProgramSketch *k : kept)
+      if (e->sketch.similarity(*k) >= similarityThreshold)
+        ++similar;
+    if (similar < maxSimilarEntries) {
+      kept.push_back(&e->sketch);
+      ++e;
+      continue;
+    }
+    ++similarEvictions;
+    e = std::make_reverse_iterator(queue.erase(std::next(e).base()));
+  }
+}
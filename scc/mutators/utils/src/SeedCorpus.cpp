@@ -0,0 +1,49 @@
+#include "scc/mutator-utils/SeedCorpus.h"
+
+#include "scc/mutator-utils/ProgramCache.h"
+#include "scc/program/ProgramSerializer.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <unordered_set>
+
+Maybe<std::vector<Program>> SeedCorpus::load(const std::string &dir,
+                                             size_t maxSeeds) {
+  std::error_code ec;
+  std::vector<std::string> paths;
+  for (const auto &entry : std::filesystem::directory_iterator(dir, ec))
+    if (entry.is_regular_file() && entry.path().extension() == extension)
+      paths.push_back(entry.path().string());
+  if (ec)
+    return Err("Failed to read seed corpus " + dir + ": " + ec.message());
+  // Directory order is arbitrary, so sort to get the same seeds every time.
+  std::sort(paths.begin(), paths.end());
+
+  struct Seed {
+    Program p;
+    size_t nodes = 0;
+  };
+  std::vector<Seed> seeds;
+  std::unordered_set<HashStream::Hash> seen;
+  for (const std::string &path : paths) {
+    Maybe<Program> p = ProgramSerializer::load(path);
+    if (p.isErr())
+      continue;
+    const ProgramCache::Digest digest = ProgramCache::digest(*p);
+    if (!digest.printable || !seen.insert(digest.hash).second)
+      continue;
+    const size_t nodes = p->countNodes();
+    seeds.push_back({std::move(*p), nodes});
+  }
+
+  std::stable_sort(
+      seeds.begin(), seeds.end(),
+      [](const Seed &l, const Seed &r) { return l.nodes < r.nodes; });
+  if (seeds.size() > maxSeeds)
+    seeds.resize(maxSeeds);
+
+  std::vector<Program> res;
+  for (Seed &s : seeds)
+    res.push_back(std::move(s.p));
+  return res;
+}
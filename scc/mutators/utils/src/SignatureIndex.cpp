@@ -0,0 +1,41 @@
+#include "scc/mutator-utils/SignatureIndex.h"
+
+bool SignatureIndex::addHit(const std::string &signature, size_t nodes) {
+  if (signature.empty())
+    return true;
+  Bucket &bucket = buckets[signature];
+  bucket.hits += 1;
+  const bool firstHits = bucket.reductions < reductionsPerSignature;
+  const bool smaller = bucket.reductions != 0 && nodes < bucket.smallestNodes;
+  if (!firstHits && !smaller) {
+    ++duplicates;
+    return false;
+  }
+  if (bucket.reductions == 0 || nodes < bucket.smallestNodes)
+    bucket.smallestNodes = nodes;
+  bucket.reductions += 1;
+  return true;
+}
+
+void SignatureIndex::save(BinaryWriter &w) const {
+  w.writeUInt(duplicates);
+  w.writeUInt(buckets.size());
+  for (const auto &bucket : buckets) {
+    w.writeString(bucket.first);
+    w.writeUInt(bucket.second.hits);
+    w.writeUInt(bucket.second.reductions);
+    w.writeUInt(bucket.second.smallestNodes);
+  }
+}
+
+void SignatureIndex::load(BinaryReader &r) {
+  duplicates = r.readUInt();
+  buckets.clear();
+  const size_t size = r.readSize();
+  for (size_t i = 0; i < size && !r.hasFailed(); ++i) {
+    Bucket &bucket = buckets[r.readString()];
+    bucket.hits = r.readUInt();
+    bucket.reductions = r.readUInt();
+    bucket.smallestNodes = r.readUInt();
+  }
+}
@@ -0,0 +1 @@
+#include "scc/mutator-utils/StrategyStats.h"
@@ -0,0 +1,159 @@
+#include "scc/mutator-utils/SurrogateModel.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+constexpr size_t numStatementKinds =
+    static_cast<size_t>(Statement::Kind::Group) + 1;
+
+/// Index of the non-histogram features.
+enum ExtraFeature {
+  Functions = numStatementKinds,
+  GlobalVars,
+  Records,
+  Types,
+  BuiltinCalls,
+  NumFeatures,
+};
+} // namespace
+
+SurrogateModel::Features SurrogateModel::extract(const Program &p) {
+  Features res(NumFeatures, 0);
+  const IdentTable &idents = p.getIdents();
+  auto countStatements = [&res, &idents](const Statement &root) {
+    root.foreachChild([&res, &idents](const Statement &s) {
+      res[static_cast<size_t>(s.getKind())] += 1;
+      if (s.getKind() == Statement::Kind::Call &&
+          idents.isFixedID(s.getCalledFuncID()))
+        res[BuiltinCalls] += 1;
+      return LoopCtrl::Continue;
+    });
+  };
+
+  for (const Decl *d : p.getDeclList()) {
+    switch (d->getKind()) {
+    case Decl::Kind::Function: {
+      res[Functions] += 1;
+      const Function *f = static_cast<const Function *>(d);
+      if (!f->isExternal())
+        countStatements(f->getBody());
+      break;
+    }
+    case Decl::Kind::GlobalVar:
+      res[GlobalVars] += 1;
+      break;
+    case Decl::Kind::Record:
+      res[Records] += 1;
+      break;
+    }
+  }
+  res[Types] = std::distance(p.getTypes().begin(), p.getTypes().end());
+
+  // Counts grow with the program size, so squash them.
+  for (float &v : res)
+    v = std::log1p(v);
+  return res;
+}
+
+float SurrogateModel::computeChance(const Features &f) const {
+  float sum = bias;
+  for (size_t i = 0; i < std::min(f.size(), weights.size()); ++i)
+    sum += weights[i] * f[i];
+  return 1 / (1 + std::exp(-sum));
+}
+
+float SurrogateModel::getThreshold() const {
+  if (recentChances.empty())
+    return 0;
+  std::vector<float> sorted(recentChances.begin(), recentChances.end());
+  const size_t index = std::min<size_t>(sorted.size() * skipFraction,
+                                        sorted.size() - 1);
+  std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+  return sorted[index];
+}
+
+SurrogateModel::Prediction SurrogateModel::predict(const Features &f,
+                                                   Rng &rng) {
+  Prediction res;
+  res.chance = computeChance(f);
+  recentChances.push_back(res.chance);
+  if (recentChances.size() > maxRecentChances)
+    recentChances.pop_front();
+
+  if (trained < warmup || skipFraction <= 0)
+    return res;
+  res.lowValue = res.chance < getThreshold();
+  res.skip = res.lowValue && !rng.withSuccessChance(explorationRate);
+  if (res.skip)
+    ++skipped;
+  return res;
+}
+
+void SurrogateModel::train(const Features &f, const Prediction &p,
+                           bool useful) {
+  ++trained;
+  const double weight =
+      p.lowValue ? 1 / std::max(explorationRate, 0.001) : 1.0;
+  if (p.lowValue && !useful)
+    truePositives += weight;
+  else if (p.lowValue)
+    falsePositives += weight;
+  else if (!useful)
+    falseNegatives += weight;
+
+  if (weights.size() < f.size())
+    weights.resize(f.size(), 0);
+  // Gradient step on the log loss.
+  const float error = (useful ? 1.0f : 0.0f) - computeChance(f);
+  for (size_t i = 0; i < f.size(); ++i)
+    weights[i] += learningRate * error * f[i];
+  bias += learningRate * error;
+}
+
+size_t SurrogateModel::getPrecision() const {
+  return 100 * truePositives / std::max(truePositives + falsePositives, 1.0);
+}
+
+size_t SurrogateModel::getRecall() const {
+  return 100 * truePositives / std::max(truePositives + falseNegatives, 1.0);
+}
+
+void SurrogateModel::save(BinaryWriter &w) const {
+  w.writeUInt(weights.size());
+  for (float weight : weights)
+    w.writeDouble(weight);
+  w.writeDouble(bias);
+  w.writeUInt(recentChances.size());
+  for (float chance : recentChances)
+    w.writeDouble(chance);
+  w.writeUInt(skipped);
+  w.writeUInt(trained);
+  w.writeDouble(truePositives);
+  w.writeDouble(falsePositives);
+  w.writeDouble(falseNegatives);
+}
+
+void SurrogateModel::load(BinaryReader &r) {
+  weights.clear();
+  const size_t numWeights = r.readSize();
+  for (size_t i = 0; i < numWeights && !r.hasFailed(); ++i)
+    weights.push_back(r.readDouble());
+  bias = r.readDouble();
+  // The model is retrained from scratch if the features changed.
+  if (weights.size() != NumFeatures) {
+    weights.clear();
+    bias = 0;
+  }
+  recentChances.clear();
+  const size_t numChances = r.readSize();
+  for (size_t i = 0; i < numChances && !r.hasFailed(); ++i)
+    recentChances.push_back(r.readDouble());
+  while (recentChances.size() > maxRecentChances)
+    recentChances.pop_front();
+  skipped = r.readUInt();
+  trained = r.readUInt();
+  truePositives = r.readDouble();
+  falsePositives = r.readDouble();
+  falseNegatives = r.readDouble();
+}
@@ -0,0 +1,42 @@
+#include "scc/mutator-utils/CandidateFilter.h"
+#include "scc/mutator-utils/GeneratorUtils.h"
+#include "gtest/gtest.h"
+
+TEST(CandidateFilter, RejectsAndCounts) {
+  Program p;
+  Function *main = GeneratorUtils::addMain(p);
+  const TypeRef t = p.getBuiltin().signed_int;
+  const Statement thrown = Statement::Throw(Statement::Constant("1", t));
+  main->setBody(Statement::CompoundStmt({Statement::If(
+      Statement::Constant("1", t), Statement::CompoundStmt({thrown}))}));
+  const ProgramCache::Digest digest = ProgramCache::digest(p);
+  ASSERT_TRUE(digest.printable);
+
+  CandidateFilter filter;
+  filter.add("unchanged", CandidateFilter::unchangedFromParent());
+  filter.add("depth", CandidateFilter::maxDepth(4));
+  // Unknown parent and not too deeply nested.
+  EXPECT_FALSE(filter.rejects({p, digest}));
+  EXPECT_TRUE(filter.rejects({p, digest, digest.hash}));
+
+  filter.add("forbidden", CandidateFilter::forbiddenConstructs());
+  EXPECT_TRUE(filter.rejects({p, digest}));
+  filter.add("bytes", CandidateFilter::maxBytes(1));
+
+  ASSERT_EQ(filter.getFilters().size(), 4U);
+  EXPECT_EQ(filter.getFilters().at(0).rejections, 1U);
+  EXPECT_EQ(filter.getFilters().at(1).rejections, 0U);
+  EXPECT_EQ(filter.getFilters().at(2).rejections, 1U);
+  EXPECT_EQ(filter.getFilters().at(3).rejections, 0U);
+}
+
+TEST(CandidateFilter, MaxDepth) {
+  Program p;
+  Function *main = GeneratorUtils::addMain(p);
+  const TypeRef t = p.getBuiltin().signed_int;
+  main->setBody(Statement::CompoundStmt(
+      {Statement::Return(Statement::Constant("1", t))}));
+  const ProgramCache::Digest digest = ProgramCache::digest(p);
+  EXPECT_TRUE(CandidateFilter::maxDepth(1)({p, digest}));
+  EXPECT_FALSE(CandidateFilter::maxDepth(2)({p, digest}));
+}
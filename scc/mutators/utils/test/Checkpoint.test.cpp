@@ -0,0 +1,53 @@
+#include "scc/mutator-utils/Checkpoint.h"
+#include "gtest/gtest.h"
+
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+namespace {
+std::string getTempDir() {
+  return (std::filesystem::temp_directory_path() /
+          ("scc-checkpoint-" + std::to_string(getpid())))
+      .string();
+}
+} // namespace
+
+TEST(Checkpoint, RoundTrip) {
+  const std::string dir = getTempDir();
+  std::filesystem::remove_all(dir);
+  EXPECT_TRUE(Checkpoint::read(dir).isErr());
+
+  const std::string state("state\0with zero", 15);
+  ASSERT_FALSE(Checkpoint::write(dir, "old"));
+  ASSERT_FALSE(Checkpoint::write(dir, state));
+  Maybe<std::string> read = Checkpoint::read(dir);
+  ASSERT_FALSE(read.isErr()) << read.getErrorMsg();
+  EXPECT_EQ(*read, state);
+  EXPECT_FALSE(std::filesystem::exists(Checkpoint::getPath(dir) + ".tmp"));
+  std::filesystem::remove_all(dir);
+}
+
+TEST(Checkpoint, RejectsCorruptFiles) {
+  const std::string dir = getTempDir();
+  std::filesystem::remove_all(dir);
+  ASSERT_FALSE(Checkpoint::write(dir, "some state"));
+  const std::string path = Checkpoint::getPath(dir);
+
+  // Flip the last byte of the state.
+  std::string data;
+  {
+    std::ifstream in(path, std::ios::binary);
+    data.assign(std::istreambuf_iterator<char>(in), {});
+  }
+  data.back() ^= 1;
+  std::ofstream(path, std::ios::binary | std::ios::trunc) << data;
+  Maybe<std::string> read = Checkpoint::read(dir);
+  ASSERT_TRUE(read.isErr());
+  EXPECT_EQ(read.getErrorMsg(), "Checksum mismatch in checkpoint " + path);
+
+  std::ofstream(path, std::ios::binary | std::ios::trunc)
+      << data.substr(0, data.size() - 3);
+  EXPECT_TRUE(Checkpoint::read(dir).isErr());
+  std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,271 @@
+#include "scc/mutator-utils/Cluster.h"
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <filesystem>
+#include <set>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+std::string getSocketPath() {
+  return (std::filesystem::temp_directory_path() /
+          ("scc-cluster-" + std::to_string(getpid())))
+      .string();
+}
+
+typedef std::unique_ptr<ClusterConnection> ConnPtr;
+
+std::pair<ConnPtr, ConnPtr> makePair() {
+  int fds[2];
+  EXPECT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+  return {std::make_unique<ClusterConnection>(fds[0]),
+          std::make_unique<ClusterConnection>(fds[1])};
+}
+
+/// Stand-in for a real scheduler: hands out a fixed number of jobs whose
+/// result is derived from the job seed.
+struct FakeScheduler : SchedulerBase {
+  size_t jobs = 0;
+  size_t nextId = 0;
+  std::set<uint64_t> running;
+  size_t applied = 0;
+  size_t dropped = 0;
+  bool sawWrongResult = false;
+
+  FakeScheduler(size_t jobs) : SchedulerBase(1), jobs(jobs) {
+    setStopAfter(jobs);
+  }
+
+  std::optional<ClusterJob> makeClusterJob() override {
+    if (applied + running.size() >= jobs)
+      return std::nullopt;
+    ClusterJob job;
+    job.id = ++nextId;
+    job.seed = job.id * 3;
+    running.insert(job.id);
+    return job;
+  }
+  void applyClusterResult(ClusterResult &res) override {
+    if (running.erase(res.jobId) == 0 ||
+        res.feedback.score !=
+            static_cast<SchedulerBase::Score>(res.jobId * 3 * 2))
+      sawWrongResult = true;
+    ++applied;
+    ++nonCacheIterations;
+  }
+  void dropClusterJob(uint64_t jobId) override {
+    running.erase(jobId);
+    ++dropped;
+  }
+  ClusterResult runClusterJob(const ClusterJob &job) override {
+    ClusterResult res;
+    res.jobId = job.id;
+    res.feedback = Feedback(job.seed * 2);
+    return res;
+  }
+};
+
+/// Returns a request for `wanted` jobs with the given results.
+std::string makeRequest(size_t wanted,
+                        const std::vector<SchedulerBase::ClusterResult> &res) {
+  BinaryWriter w;
+  w.writeUInt(wanted);
+  w.writeUInt(res.size());
+  for (const SchedulerBase::ClusterResult &r : res)
+    r.save(w);
+  return w.getData();
+}
+
+/// Runs a worker in this (forked) process. Returns the exit code.
+int runWorker(const std::string &address, size_t maxSteps) {
+  FakeScheduler sched(0);
+  auto worker = ClusterWorker::connect(sched, address, 4);
+  if (worker.isErr())
+    return 2;
+  for (size_t i = 0; i < maxSteps; ++i)
+    if (!(*worker)->step())
+      return 0;
+  // Simulates a crash with unfinished jobs.
+  return 1;
+}
+} // namespace
+
+TEST(Cluster, SendsBatchedFrames) {
+  auto [a, b] = makePair();
+  const std::string big(100000, 'x');
+  a->queueFrame("first");
+  a->queueFrame("");
+  a->queueFrame(big);
+  // Send from another thread as the frames don't fit in the socket buffer.
+  std::thread sender([&a = a]() { EXPECT_TRUE(a->flush()); });
+  EXPECT_EQ(b->waitForFrame(), "first");
+  EXPECT_EQ(b->waitForFrame(), "");
+  EXPECT_EQ(b->waitForFrame(), big);
+  sender.join();
+  EXPECT_EQ(b->popFrame(), std::nullopt);
+
+  // A closed connection ends the stream.
+  close(a->getFD());
+  EXPECT_EQ(b->waitForFrame(), std::nullopt);
+}
+
+TEST(Cluster, RejectsHugeFrames) {
+  auto [a, b] = makePair();
+  // Header announcing a frame of 4 GiB.
+  const char header[] = {'\xff', '\xff', '\xff', '\xff'};
+  ASSERT_EQ(write(a->getFD(), header, sizeof(header)), 4);
+  EXPECT_FALSE(b->receive());
+}
+
+TEST(Cluster, ConnectsOverUnixAndTCP) {
+  for (std::string address :
+       {"unix:" + getSocketPath(), std::string("tcp:127.0.0.1:0")}) {
+    auto listener = ClusterListener::listen(address);
+    ASSERT_FALSE(listener.isErr()) << listener.getErrorMsg();
+    EXPECT_EQ((*listener)->accept(), nullptr);
+    if (address.find("tcp:") == 0) {
+      EXPECT_NE((*listener)->getAddress(), address);
+    }
+
+    auto client = ClusterConnection::connect((*listener)->getAddress());
+    ASSERT_FALSE(client.isErr()) << client.getErrorMsg();
+    std::unique_ptr<ClusterConnection> server;
+    while (!server)
+      server = (*listener)->accept();
+    (*client)->queueFrame("ping");
+    ASSERT_TRUE((*client)->flush());
+    EXPECT_EQ(server->waitForFrame(), "ping");
+  }
+  EXPECT_FALSE(std::filesystem::exists(getSocketPath()));
+
+  EXPECT_TRUE(ClusterListener::listen("udp:1234").isErr());
+  EXPECT_TRUE(ClusterListener::listen("tcp:localhost").isErr());
+  EXPECT_TRUE(ClusterConnection::connect("unix:" + getSocketPath()).isErr());
+}
+
+TEST(Cluster, SurvivesLostWorkers) {
+  const size_t totalJobs = 200;
+  FakeScheduler sched(totalJobs);
+  auto coordinator = ClusterCoordinator::listen(
+      sched, []() {}, "unix:" + getSocketPath());
+  ASSERT_FALSE(coordinator.isErr()) << coordinator.getErrorMsg();
+  const std::string address = (*coordinator)->getAddress();
+
+  std::vector<pid_t> workers;
+  auto startWorker = [&](size_t maxSteps) {
+    pid_t pid = fork();
+    ASSERT_NE(pid, -1);
+    if (pid == 0)
+      _exit(runWorker(address, maxSteps));
+    workers.push_back(pid);
+  };
+  // The first worker dies after its first batch, the others run until the
+  // end.
+  startWorker(1);
+  for (unsigned i = 0; i < 1000 && (*coordinator)->getLostWorkers() == 0; ++i)
+    (*coordinator)->poll(10);
+  ASSERT_EQ((*coordinator)->getLostWorkers(), 1U);
+  startWorker(1000000);
+  startWorker(1000000);
+
+  for (unsigned i = 0; i < 100000 && !sched.finished(); ++i)
+    (*coordinator)->poll(10);
+  EXPECT_TRUE(sched.finished());
+  // Let the remaining workers know that fuzzing finished.
+  for (unsigned i = 0; i < 1000 && (*coordinator)->getNumWorkers() != 0; ++i)
+    (*coordinator)->poll(10);
+
+  std::vector<int> exitCodes;
+  for (pid_t pid : workers) {
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    ASSERT_TRUE(WIFEXITED(status));
+    exitCodes.push_back(WEXITSTATUS(status));
+  }
+  EXPECT_EQ(exitCodes, std::vector<int>({1, 0, 0}));
+
+  EXPECT_FALSE(sched.sawWrongResult);
+  EXPECT_EQ(sched.applied, totalJobs);
+  EXPECT_EQ((*coordinator)->getCompletedJobs(), totalJobs);
+  EXPECT_EQ((*coordinator)->getLostWorkers(), 1U);
+  EXPECT_EQ((*coordinator)->getLostJobs(), 4U);
+  EXPECT_EQ(sched.dropped, 4U);
+}
+
+TEST(Cluster, DropsJobsAfterTimeout) {
+  FakeScheduler sched(100);
+  auto coordinator = ClusterCoordinator::listen(
+      sched, []() {}, "unix:" + getSocketPath());
+  ASSERT_FALSE(coordinator.isErr()) << coordinator.getErrorMsg();
+  (*coordinator)->setJobTimeout(20);
+  auto worker = ClusterConnection::connect((*coordinator)->getAddress());
+  ASSERT_FALSE(worker.isErr()) << worker.getErrorMsg();
+
+  (*worker)->queueFrame(makeRequest(3, {}));
+  ASSERT_TRUE((*worker)->flush());
+  for (unsigned i = 0; i < 1000 && sched.running.size() < 3; ++i)
+    (*coordinator)->poll(10);
+  ASSERT_EQ(sched.running.size(), 3U);
+  const std::set<uint64_t> jobs = sched.running;
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  (*coordinator)->poll(0);
+  EXPECT_EQ((*coordinator)->getTimedOutJobs(), 3U);
+  EXPECT_EQ(sched.dropped, 3U);
+  EXPECT_TRUE(sched.running.empty());
+
+  // Results that arrive after the timeout are ignored.
+  std::vector<SchedulerBase::ClusterResult> late;
+  for (uint64_t job : jobs) {
+    SchedulerBase::ClusterJob j;
+    j.id = job;
+    j.seed = job * 3;
+    late.push_back(sched.runClusterJob(j));
+  }
+  (*worker)->queueFrame(makeRequest(0, late));
+  ASSERT_TRUE((*worker)->flush());
+  for (unsigned i = 0; i < 100 && (*coordinator)->getCompletedJobs() == 0; ++i)
+    (*coordinator)->poll(1);
+  EXPECT_EQ(sched.applied, 0U);
+  EXPECT_EQ((*coordinator)->getNumWorkers(), 1U);
+}
+
+TEST(Cluster, WorkersThatDontReadDontBlock) {
+  FakeScheduler sched(1000000);
+  auto coordinator = ClusterCoordinator::listen(
+      sched, []() {}, "unix:" + getSocketPath());
+  ASSERT_FALSE(coordinator.isErr()) << coordinator.getErrorMsg();
+  auto stuck = ClusterConnection::connect((*coordinator)->getAddress());
+  ASSERT_FALSE(stuck.isErr()) << stuck.getErrorMsg();
+
+  // The replies to these requests don't fit into the socket buffer.
+  std::atomic<bool> sent = false;
+  std::thread sender([&stuck, &sent]() {
+    for (unsigned i = 0; i < 500; ++i) {
+      (*stuck)->queueFrame(
+          makeRequest(ClusterCoordinator::maxBatchSize, {}));
+      if (!(*stuck)->flush())
+        break;
+    }
+    sent = true;
+  });
+  const size_t allJobs = 500 * ClusterCoordinator::maxBatchSize;
+  for (unsigned i = 0; i < 100000 && (!sent || sched.running.size() < allJobs);
+       ++i)
+    (*coordinator)->poll(1);
+  sender.join();
+  ASSERT_EQ(sched.running.size(), allJobs);
+
+  // Other workers are still served.
+  const size_t running = sched.running.size();
+  auto worker = ClusterConnection::connect((*coordinator)->getAddress());
+  ASSERT_FALSE(worker.isErr()) << worker.getErrorMsg();
+  (*worker)->queueFrame(makeRequest(1, {}));
+  ASSERT_TRUE((*worker)->flush());
+  for (unsigned i = 0; i < 1000 && sched.running.size() == running; ++i)
+    (*coordinator)->poll(1);
+  EXPECT_EQ(sched.running.size(), running + 1);
+}
@@ -0,0 +1,33 @@
+#include "scc/mutator-utils/ConstantDictionary.h"
+#include "gtest/gtest.h"
+
+TEST(ConstantDictionary, DeduplicatesAndEvictsRareEntries) {
+  ConstantDictionary dict;
+  dict.setCapacity(2);
+  EXPECT_TRUE(dict.addFromOracle("int:1234"));
+  EXPECT_TRUE(dict.addFromOracle("int:1234"));
+  EXPECT_TRUE(dict.addFromOracle("int:7"));
+  EXPECT_FALSE(dict.addFromOracle("int"));
+  EXPECT_FALSE(dict.addFromOracle(":7"));
+  EXPECT_EQ(dict.size(), 2U);
+  EXPECT_EQ(dict.getEntries().front().frequency, 2U);
+
+  // The least frequent entry is replaced.
+  dict.add("unsigned long", "0xdeadbeef");
+  EXPECT_EQ(dict.size(), 2U);
+  EXPECT_EQ(dict.getEntries().front().value, "1234");
+  EXPECT_EQ(dict.getEntries().back().value, "0xdeadbeef");
+}
+
+TEST(ConstantDictionary, PicksMatchingType) {
+  ConstantDictionary dict;
+  Rng rng(RngSource(1));
+  EXPECT_FALSE(dict.pick(rng, "int"));
+  dict.add("unsigned long", "1UL");
+  EXPECT_FALSE(dict.pick(rng, "int"));
+  dict.add("int", "42");
+  for (unsigned i = 0; i < 10; ++i)
+    EXPECT_EQ(dict.pick(rng, "int"), "42");
+  dict.add("*", "0");
+  EXPECT_TRUE(dict.pick(rng, "unsigned long"));
+}
@@ -0,0 +1,72 @@
+#include "scc/mutator-utils/CorpusSync.h"
+#include "scc/mutator-utils/ProgramCache.h"
+#include "scc/program/GlobalVar.h"
+#include "gtest/gtest.h"
+
+#include <filesystem>
+#include <unistd.h>
+
+namespace {
+std::string getTempDir() {
+  return (std::filesystem::temp_directory_path() /
+          ("scc-sync-" + std::to_string(getpid())))
+      .string();
+}
+
+Program makeProgram(unsigned globals) {
+  Program p;
+  for (unsigned i = 0; i < globals; ++i)
+    p.add(std::make_unique<GlobalVar>(p.getBuiltin().signed_int,
+                                      p.getIdents().makeNewID("g")));
+  return p;
+}
+
+void exportProgram(CorpusSync &sync, const Program &p) {
+  ASSERT_FALSE(sync.exportProgram(p, ProgramCache::digest(p).hash));
+}
+} // namespace
+
+TEST(CorpusSync, SecondariesOnlyImportFromPrimary) {
+  const std::string dir = getTempDir();
+  std::filesystem::remove_all(dir);
+  CorpusSync primary(dir, "main", true);
+  CorpusSync a(dir, "a", false);
+  CorpusSync b(dir, "b", false);
+  ASSERT_FALSE(primary.init());
+  ASSERT_FALSE(a.init());
+  ASSERT_FALSE(b.init());
+
+  exportProgram(primary, makeProgram(1));
+  exportProgram(a, makeProgram(2));
+  exportProgram(a, makeProgram(2));
+  EXPECT_EQ(a.getExported(), 1U);
+
+  // The primary sees the program of a, b only the one of the primary.
+  EXPECT_EQ(primary.importNew(10).size(), 1U);
+  std::vector<Program> imported = b.importNew(10);
+  ASSERT_EQ(imported.size(), 1U);
+  EXPECT_EQ(imported.front().getDeclList().size(), 1U);
+  // Programs are only imported once.
+  EXPECT_TRUE(b.importNew(10).empty());
+
+  // Imported programs are not exported again.
+  exportProgram(b, imported.front());
+  EXPECT_EQ(b.getExported(), 0U);
+  std::filesystem::remove_all(dir);
+}
+
+TEST(CorpusSync, RespectsImportBudget) {
+  const std::string dir = getTempDir();
+  std::filesystem::remove_all(dir);
+  CorpusSync primary(dir, "main", true);
+  CorpusSync a(dir, "a", false);
+  ASSERT_FALSE(primary.init());
+  ASSERT_FALSE(a.init());
+  for (unsigned i = 0; i < 5; ++i)
+    exportProgram(primary, makeProgram(i));
+
+  EXPECT_EQ(a.importNew(3).size(), 3U);
+  EXPECT_EQ(a.importNew(3).size(), 2U);
+  EXPECT_EQ(a.getImported(), 5U);
+  std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,58 @@
+#include "scc/mutator-utils/Crossover.h"
+#include "scc/mutator-utils/GeneratorUtils.h"
+#include "scc/program/GlobalVar.h"
+#include "scc/program/RecordDecl.h"
+#include "gtest/gtest.h"
+
+TEST(Crossover, TransplantsFunctionWithDependencies) {
+  Program src;
+  GeneratorUtils::addMain(src);
+  const TypeRef t = src.getBuiltin().signed_int;
+  const NameID field = src.getIdents().makeNewID("f");
+  Record &record = src.add(Record::Struct(
+      src, src.getIdents().makeNewID("S"), {Record::Field(field, t)}));
+  Variable global(record.getType(), src.getIdents().makeNewID("g"));
+  src.add(std::make_unique<GlobalVar>(global.getType(), global.getName()));
+  auto func = std::make_unique<Function>(t, src.getIdents().makeNewID("func"),
+                                         std::vector<Variable>());
+  func->setBody(Statement::CompoundStmt({Statement::Return(
+      Statement::Dot(t, Statement::GlobalVarRef(global), field))}));
+  const Function &transplanted = src.add(std::move(func));
+
+  Program dst;
+  GeneratorUtils::addMain(dst);
+  Crossover crossover(dst, src);
+  crossover.transplantDecl(transplanted);
+
+  // main, the function, the global and the record.
+  EXPECT_EQ(dst.getDeclList().size(), 4U);
+  EXPECT_TRUE(dst.canPrint());
+
+  // Transplanting again reuses the copied declarations.
+  crossover.transplantDecl(transplanted);
+  EXPECT_EQ(dst.getDeclList().size(), 4U);
+}
+
+TEST(Crossover, RejectsStatementsUsingOuterLocals) {
+  Program src;
+  GeneratorUtils::addMain(src);
+  const TypeRef t = src.getBuiltin().signed_int;
+  Variable local(t, src.getIdents().makeNewID("l"));
+  const Statement use = Statement::StmtExpr(Statement::LocalVarRef(local));
+
+  Program dst;
+  GeneratorUtils::addMain(dst);
+  Crossover crossover(dst, src);
+  EXPECT_TRUE(crossover.transplantStatement(use).isErr());
+  EXPECT_TRUE(crossover.transplantStatement(Statement::Break()).isErr());
+
+  const Statement withDecl =
+      Statement::CompoundStmt({Statement::VarDecl(t, local.getName()), use});
+  Maybe<Statement> copy = crossover.transplantStatement(withDecl);
+  ASSERT_FALSE(copy.isErr());
+  // Declaration and use are remapped to the same new variable.
+  const NameID declared = copy->getChildren().front().getDeclaredVarID();
+  const Statement &ref = copy->getChildren().back().getChildren().front();
+  EXPECT_EQ(ref.getReferencedVarID(), declared);
+  EXPECT_TRUE(dst.getIdents().isValidID(declared));
+}
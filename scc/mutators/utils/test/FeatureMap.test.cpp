@@ -0,0 +1,16 @@
+#include "scc/mutator-utils/FeatureMap.h"
+#include "gtest/gtest.h"
+
+TEST(FeatureMap, BucketsHitCounts) {
+  const uint8_t counters[] = {0, 1, 3, 5, 200};
+  const std::vector<uint32_t> expected = {8, 18, 27, 39};
+  EXPECT_EQ(FeatureMap::collectFeatures(counters, sizeof(counters)), expected);
+}
+
+TEST(FeatureMap, CountsNewFeatures) {
+  FeatureMap map;
+  EXPECT_EQ(map.addFeatures({3, 100}), 2U);
+  EXPECT_EQ(map.addFeatures({3, 100}), 0U);
+  EXPECT_EQ(map.addFeatures({4, 100}), 1U);
+  EXPECT_EQ(map.getNumFeatures(), 3U);
+}
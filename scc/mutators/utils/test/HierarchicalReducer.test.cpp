@@ -0,0 +1,58 @@
+#include "scc/mutator-utils/HierarchicalReducer.h"
+#include "scc/mutator-utils/GeneratorUtils.h"
+#include "scc/program/GlobalVar.h"
+#include "gtest/gtest.h"
+
+TEST(HierarchicalReducer, ReducesToInterestingAssignment) {
+  Program p;
+  Function *main = GeneratorUtils::addMain(p);
+  const TypeRef t = p.getBuiltin().signed_int;
+  Variable keep(t, p.getIdents().createID("keep"));
+  Variable other(t, p.getIdents().makeNewID("g"));
+  Variable local(t, p.getIdents().makeNewID("l"));
+  p.add(std::make_unique<GlobalVar>(t, keep.getName()));
+  p.add(std::make_unique<GlobalVar>(t, other.getName()));
+  for (unsigned i = 0; i < 5; ++i)
+    p.add(std::make_unique<GlobalVar>(t, p.getIdents().makeNewID("g")));
+
+  auto add = [&p, t](Statement lhs, const std::string &rhs) {
+    return Statement::BinaryOp(p, Statement::Kind::Add, lhs,
+                               Statement::Constant(rhs, t));
+  };
+  auto assign = [&p](const Variable &v, Statement val) {
+    return Statement::StmtExpr(
+        Statement::Assign(p, Statement::GlobalVarRef(v), val));
+  };
+  std::vector<Statement> inner = {
+      assign(other, add(Statement::LocalVarRef(local), "3")),
+      assign(keep, add(add(Statement::LocalVarRef(local), "4"), "5")),
+  };
+  main->setBody(Statement::CompoundStmt({
+      Statement::VarDef(t, local.getName(), Statement::Constant("1", t)),
+      Statement::If(Statement::Constant("1", t),
+                    Statement::CompoundStmt(inner)),
+      assign(other, Statement::Constant("7", t)),
+      Statement::Return(Statement::Constant("0", t)),
+  }));
+
+  auto feedback = [](const Program &p) {
+    OutString out;
+    p.print(out).assumeSuccess("Failed to print");
+    SchedulerBase::Feedback res;
+    res.interesting = out.getStr().find("(keep=") != std::string::npos;
+    return res;
+  };
+
+  HierarchicalReducer reducer(feedback, p);
+  while (!reducer.finished())
+    reducer.step();
+
+  const Program &reduced = reducer.getProgram();
+  EXPECT_TRUE(feedback(reduced).interesting);
+  // Only main and the assigned global remain.
+  EXPECT_EQ(reduced.getDeclList().size(), 2U);
+  EXPECT_LT(reduced.countNodes(), p.countNodes());
+  // Removing the local variable alone leaves dangling references, which is
+  // detected without calling the oracle.
+  EXPECT_GT(reducer.getStats().skippedCandidates, 0U);
+}
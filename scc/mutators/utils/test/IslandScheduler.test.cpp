@@ -0,0 +1,75 @@
+#include "scc/mutator-utils/IslandScheduler.h"
+#include "scc/program/GlobalVar.h"
+#include "gtest/gtest.h"
+
+#include <set>
+
+namespace {
+/// Exposes the mailboxes for testing.
+struct TestIslands : IslandSchedulerBase {
+  using IslandSchedulerBase::IslandSchedulerBase;
+  using IslandSchedulerBase::publish;
+  using IslandSchedulerBase::sendMigrants;
+  using IslandSchedulerBase::takeErrors;
+  using IslandSchedulerBase::takeFindings;
+  using IslandSchedulerBase::takeMigrants;
+};
+
+Program makeProgram(unsigned globals) {
+  Program p;
+  for (unsigned i = 0; i < globals; ++i)
+    p.add(std::make_unique<GlobalVar>(p.getBuiltin().signed_int,
+                                      p.getIdents().makeNewID()));
+  return p;
+}
+} // namespace
+
+TEST(IslandScheduler, ParseTopologies) {
+  for (MigrationTopology t :
+       {MigrationTopology::Ring, MigrationTopology::Random}) {
+    Maybe<MigrationTopology> parsed =
+        parseMigrationTopology(getMigrationTopologyName(t));
+    ASSERT_TRUE(parsed);
+    EXPECT_EQ(*parsed, t);
+  }
+  EXPECT_FALSE(parseMigrationTopology("star"));
+}
+
+TEST(IslandScheduler, MigrationTargets) {
+  Rng rng(RngSource(1));
+  EXPECT_EQ(pickMigrationTarget(MigrationTopology::Ring, 0, 3, rng), 1U);
+  EXPECT_EQ(pickMigrationTarget(MigrationTopology::Ring, 2, 3, rng), 0U);
+
+  std::set<size_t> targets;
+  for (unsigned i = 0; i < 200; ++i)
+    targets.insert(pickMigrationTarget(MigrationTopology::Random, 1, 4, rng));
+  EXPECT_EQ(targets, std::set<size_t>({0, 2, 3}));
+}
+
+TEST(IslandScheduler, Mailboxes) {
+  TestIslands islands(3);
+  Rng rng(RngSource(1));
+  std::vector<Program> migrants;
+  migrants.push_back(makeProgram(1));
+  migrants.push_back(makeProgram(2));
+  islands.sendMigrants(2, std::move(migrants), rng);
+  EXPECT_TRUE(islands.takeMigrants(1).empty());
+  EXPECT_EQ(islands.takeMigrants(0).size(), 2U);
+  EXPECT_TRUE(islands.takeMigrants(0).empty());
+
+  IslandStats stats;
+  stats.iterations = 10;
+  std::vector<Program> findings;
+  findings.push_back(makeProgram(3));
+  islands.publish(1, stats, std::move(findings), {"Failed to write"});
+  EXPECT_EQ(islands.takeFindings(1).size(), 1U);
+  EXPECT_TRUE(islands.takeFindings(1).empty());
+  EXPECT_EQ(islands.takeErrors(1), std::vector<std::string>{"Failed to write"});
+  EXPECT_TRUE(islands.takeErrors(1).empty());
+
+  const std::vector<IslandStats> all = islands.getIslandStats();
+  ASSERT_EQ(all.size(), 3U);
+  EXPECT_EQ(all.at(0).migrantsReceived, 2U);
+  EXPECT_EQ(all.at(1).iterations, 10U);
+  EXPECT_EQ(all.at(2).migrantsSent, 2U);
+}
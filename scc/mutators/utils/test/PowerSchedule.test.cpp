@@ -0,0 +1,44 @@
+#include "scc/mutator-utils/PowerSchedule.h"
+#include "gtest/gtest.h"
+
+TEST(PowerSchedule, ParseNames) {
+  for (PowerSchedule s : {PowerSchedule::Fixed, PowerSchedule::Exploit,
+                          PowerSchedule::Explore, PowerSchedule::Fast,
+                          PowerSchedule::Coe}) {
+    Maybe<PowerSchedule> parsed = parsePowerSchedule(getPowerScheduleName(s));
+    ASSERT_TRUE(parsed);
+    EXPECT_EQ(*parsed, s);
+  }
+  EXPECT_FALSE(parsePowerSchedule("foo"));
+}
+
+TEST(PowerSchedule, BetterEntriesGetMoreEnergy) {
+  QueueEntryStats best;
+  best.queueSize = 100;
+  best.nodes = best.averageNodes = 100;
+  QueueEntryStats worst = best;
+  worst.rank = 99;
+  for (PowerSchedule s : {PowerSchedule::Exploit, PowerSchedule::Explore,
+                          PowerSchedule::Fast, PowerSchedule::Coe})
+    EXPECT_GT(computeEnergy(s, best, 1000), computeEnergy(s, worst, 1000));
+  EXPECT_LT(computeEnergy(PowerSchedule::Explore, best, 1000),
+            computeEnergy(PowerSchedule::Exploit, best, 1000));
+}
+
+TEST(PowerSchedule, FastAndCoe) {
+  QueueEntryStats e;
+  e.queueSize = 10;
+  e.rank = 5;
+  e.picks = 3;
+  QueueEntryStats fresh = e;
+  fresh.picks = 0;
+  EXPECT_GT(computeEnergy(PowerSchedule::Fast, e, 10000),
+            computeEnergy(PowerSchedule::Fast, fresh, 10000));
+
+  // Entries with more fruitless runs than average are skipped by COE.
+  e.fruitlessRuns = 100;
+  e.averageFruitlessRuns = 10;
+  EXPECT_EQ(computeEnergy(PowerSchedule::Coe, e, 10000), 0U);
+  EXPECT_GT(computeEnergy(PowerSchedule::Fast, e, 10000), 0U);
+  EXPECT_EQ(computeEnergy(PowerSchedule::Exploit, e, 5), 5U);
+}
@@ -0,0 +1,36 @@
+#include "scc/mutator-utils/ProgramLineage.h"
+#include "scc/mutator-utils/GeneratorUtils.h"
+#include "scc/program/GlobalVar.h"
+#include "gtest/gtest.h"
+
+namespace {
+void addGlobal(Program &p) {
+  p.add(std::make_unique<GlobalVar>(p.getBuiltin().signed_int,
+                                    p.getIdents().makeNewID("g")));
+}
+} // namespace
+
+TEST(ProgramLineage, ReplayRebuildsProgram) {
+  Program p;
+  GeneratorUtils::addMain(p);
+  ProgramLineage::Ref root = ProgramLineage::makeKeyframe(p);
+
+  const size_t maxReplayDepth = 3;
+  ProgramLineage::Ref current = root;
+  for (unsigned i = 0; i < 5; ++i) {
+    addGlobal(p);
+    current = ProgramLineage::makeChild(current, addGlobal, p, maxReplayDepth);
+  }
+  EXPECT_LE(current->replayDepth, maxReplayDepth);
+
+  MaterializedPrograms materialized;
+  std::shared_ptr<const Program> rebuilt = materialized.get(current);
+  EXPECT_EQ(ProgramLineage::hashProgram(*rebuilt),
+            ProgramLineage::hashProgram(p));
+  EXPECT_EQ(rebuilt->getDeclList().size(), p.getDeclList().size());
+
+  // The second lookup is served from the cache.
+  const size_t replays = materialized.getReplays();
+  EXPECT_EQ(materialized.get(current), rebuilt);
+  EXPECT_EQ(materialized.getReplays(), replays);
+}
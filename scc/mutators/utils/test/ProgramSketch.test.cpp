@@ -0,0 +1,46 @@
+#include "scc/mutator-utils/ProgramSketch.h"
+#include "scc/mutator-utils/GeneratorUtils.h"
+#include "gtest/gtest.h"
+
+namespace {
+/// Creates a main function whose body has the given statements.
+Program makeProgram(const std::vector<Statement> &body) {
+  Program p;
+  Function *main = GeneratorUtils::addMain(p);
+  main->setBody(Statement::CompoundStmt(body));
+  return p;
+}
+
+/// Returns a loop that contains the given statement.
+Statement makeLoop(const Program &p, Statement body) {
+  return Statement::While(Statement::Constant("1", p.getBuiltin().signed_int),
+                          Statement::CompoundStmt({body}));
+}
+} // namespace
+
+TEST(ProgramSketch, ComparesStructure) {
+  Program empty = makeProgram({});
+  Program loop =
+      makeProgram({makeLoop(empty, Statement::Break()), Statement::Empty()});
+  Program sameLoop =
+      makeProgram({makeLoop(empty, Statement::Break()), Statement::Empty()});
+  Statement innerLoop = makeLoop(empty, Statement::Continue());
+  Program nested =
+      makeProgram({makeLoop(empty, makeLoop(empty, innerLoop))});
+
+  const ProgramSketch loopSketch = ProgramSketch::compute(loop);
+  EXPECT_FALSE(loopSketch.empty());
+  EXPECT_EQ(loopSketch.similarity(ProgramSketch::compute(sameLoop)), 1.0);
+  const double toNested =
+      loopSketch.similarity(ProgramSketch::compute(nested));
+  const double toEmpty = loopSketch.similarity(ProgramSketch::compute(empty));
+  EXPECT_LT(toNested, 1.0);
+  EXPECT_LT(toEmpty, 1.0);
+}
+
+TEST(ProgramSketch, EmptySketchesAreNotSimilar) {
+  const ProgramSketch computed = ProgramSketch::compute(makeProgram({}));
+  EXPECT_TRUE(ProgramSketch().empty());
+  EXPECT_EQ(computed.similarity(ProgramSketch()), 0.0);
+  EXPECT_EQ(ProgramSketch().similarity(ProgramSketch()), 0.0);
+}
@@ -0,0 +1,88 @@
+#include "scc/mutator-utils/ReductionQueue.h"
+#include "scc/program/GlobalVar.h"
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace {
+struct NoStrategy {
+  static std::vector<NoStrategy> makeReductionStrategies() { return {{}}; }
+};
+
+/// A generator without reduction strategies, so only the hierarchical pass
+/// of the reducer removes anything.
+struct NoGenerator {
+  typedef NoStrategy Strategy;
+  std::vector<int> reduce(Program &, RngSource, const Strategy &) {
+    return {};
+  }
+};
+
+Program makeProgram(unsigned globals) {
+  Program p;
+  for (unsigned i = 0; i < globals; ++i)
+    p.add(std::make_unique<GlobalVar>(p.getBuiltin().signed_int,
+                                      p.getIdents().makeNewID()));
+  return p;
+}
+
+size_t countGlobals(const Program &p) {
+  size_t res = 0;
+  for (const Decl *d : p.getDeclList())
+    res += d->getKind() == Decl::Kind::GlobalVar;
+  return res;
+}
+
+/// Programs with at least one global are interesting.
+SchedulerBase::Feedback hasGlobal(const Program &p) {
+  SchedulerBase::Feedback res(0);
+  res.interesting = countGlobals(p) != 0;
+  return res;
+}
+} // namespace
+
+TEST(ReductionQueue, ReducesQueuedFindings) {
+  ReductionQueue<NoGenerator> queue(hasGlobal, /*concurrency=*/2,
+                                    /*reducerTries=*/10);
+  for (unsigned i = 0; i < 3; ++i)
+    queue.add(makeProgram(5), /*seed=*/i);
+
+  std::vector<Program> reduced;
+  while (reduced.size() < 3) {
+    for (Program &p : queue.popFinished())
+      reduced.push_back(std::move(p));
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(queue.getUnfinished(), 0U);
+  for (const Program &p : reduced)
+    EXPECT_EQ(countGlobals(p), 1U);
+}
+
+TEST(ReductionQueue, DestructionStopsRunningReductions) {
+  std::atomic<size_t> calls = 0;
+  {
+    // No global can be removed and the oracle is slow, so the reductions
+    // take much longer than the test.
+    ReductionQueue<NoGenerator> queue(
+        [&calls](const Program &p) {
+          ++calls;
+          std::this_thread::sleep_for(std::chrono::milliseconds(1));
+          SchedulerBase::Feedback res(0);
+          res.interesting = countGlobals(p) == 1000;
+          return res;
+        },
+        /*concurrency=*/1, /*reducerTries=*/1000000);
+    queue.add(makeProgram(1000), /*seed=*/1);
+    queue.add(makeProgram(1000), /*seed=*/2);
+    while (calls == 0)
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    EXPECT_EQ(queue.getPending(), 1U);
+    EXPECT_EQ(queue.getUnfinished(), 2U);
+  }
+  // The worker was joined, so the feedback isn't called anymore.
+  const size_t callsAfterDestruction = calls;
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_EQ(calls, callsAfterDestruction);
+}
@@ -0,0 +1,132 @@
+#include "scc/mutator-utils/ResultStore.h"
+#include "scc/utils/OutStream.h"
+#include "gtest/gtest.h"
+
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+namespace {
+std::string getTempPath() {
+  return (std::filesystem::temp_directory_path() /
+          ("scc-results-" + std::to_string(getpid())))
+      .string();
+}
+} // namespace
+
+TEST(ResultStore, PersistsAndSkipsDamagedRecords) {
+  const std::string path = getTempPath();
+  std::filesystem::remove(path);
+  ResultStore::Result r;
+  r.score = -12;
+  r.interesting = true;
+  r.msg = "crash";
+  {
+    auto store = ResultStore::open(path, 1 << 20);
+    ASSERT_FALSE(store.isErr());
+    EXPECT_FALSE((*store)->lookup(1, 1));
+    (*store)->store(1, 1, r);
+    (*store)->store(2, 1, ResultStore::Result());
+  }
+  const auto validSize = std::filesystem::file_size(path);
+  // Simulate a crash in the middle of an append.
+  std::ofstream(path, std::ios::app) << "SCCR garbage";
+
+  auto store = ResultStore::open(path, 1 << 20);
+  ASSERT_FALSE(store.isErr());
+  // Another process might still be appending, so nothing is cut off.
+  EXPECT_GT(std::filesystem::file_size(path), validSize);
+  EXPECT_EQ((*store)->getNumResults(), 2U);
+  std::optional<ResultStore::Result> found = (*store)->lookup(1, 1);
+  ASSERT_TRUE(found);
+  EXPECT_EQ(found->score, -12);
+  EXPECT_TRUE(found->interesting);
+  EXPECT_FALSE(found->deadEnd);
+  EXPECT_EQ(found->msg, "crash");
+  EXPECT_EQ((*store)->getHits(), 1U);
+
+  // Records behind the damaged one are still found.
+  (*store)->store(3, 1, r);
+  auto reopened = ResultStore::open(path, 1 << 20);
+  ASSERT_FALSE(reopened.isErr());
+  EXPECT_EQ((*reopened)->getNumResults(), 3U);
+  EXPECT_TRUE((*reopened)->lookup(3, 1));
+  std::filesystem::remove(path);
+}
+
+TEST(ResultStore, SeesAppendsOfOtherInstancesAndRespectsMaxSize) {
+  const std::string path = getTempPath();
+  std::filesystem::remove(path);
+  auto a = ResultStore::open(path, 1 << 20);
+  auto b = ResultStore::open(path, 1 << 20);
+  ASSERT_FALSE(a.isErr());
+  ASSERT_FALSE(b.isErr());
+  (*a)->store(7, 1, ResultStore::Result());
+  EXPECT_TRUE((*b)->lookup(7, 1));
+
+  auto full = ResultStore::open(path, 0);
+  ASSERT_FALSE(full.isErr());
+  (*full)->store(8, 1, ResultStore::Result());
+  EXPECT_FALSE((*b)->lookup(8, 1));
+  std::filesystem::remove(path);
+}
+
+TEST(ResultStore, WaitsForRecordsThatAreStillAppended) {
+  const std::string path = getTempPath();
+  std::filesystem::remove(path);
+  {
+    auto writer = ResultStore::open(path, 1 << 20);
+    ASSERT_FALSE(writer.isErr());
+    (*writer)->store(5, 1, ResultStore::Result());
+  }
+  std::string record;
+  {
+    std::ifstream in(path, std::ios::binary);
+    record.assign(std::istreambuf_iterator<char>(in), {});
+  }
+  // Only the first half of the record was written so far.
+  const size_t half = record.size() / 2;
+  std::ofstream(path, std::ios::binary | std::ios::trunc)
+      << record.substr(0, half);
+
+  auto store = ResultStore::open(path, 1 << 20);
+  ASSERT_FALSE(store.isErr());
+  EXPECT_FALSE((*store)->lookup(5, 1));
+  EXPECT_EQ(std::filesystem::file_size(path), half);
+
+  std::ofstream(path, std::ios::binary | std::ios::app) << record.substr(half);
+  EXPECT_TRUE((*store)->lookup(5, 1));
+  std::filesystem::remove(path);
+}
+
+TEST(ResultStore, DistinguishesProgramsWithTheSameFragments) {
+  const std::string path = getTempPath();
+  std::filesystem::remove(path);
+  // Two programs that only differ in the order of their printed fragments.
+  HashStream first;
+  first << "int f();\n" << "int g();\n";
+  HashStream second;
+  second << "int g();\n" << "int f();\n";
+  ASSERT_EQ(first.getHash(), second.getHash());
+  ASSERT_EQ(first.getSize(), second.getSize());
+  EXPECT_NE(first.getContentHash(), second.getContentHash());
+
+  auto store = ResultStore::open(path, 1 << 20);
+  ASSERT_FALSE(store.isErr());
+  ResultStore::Result r;
+  r.interesting = true;
+  (*store)->store(first.getContentHash(), first.getSize(), r);
+  (*store)->store(second.getContentHash(), second.getSize(),
+                  ResultStore::Result());
+  std::optional<ResultStore::Result> found =
+      (*store)->lookup(first.getContentHash(), first.getSize());
+  ASSERT_TRUE(found);
+  EXPECT_TRUE(found->interesting);
+  found = (*store)->lookup(second.getContentHash(), second.getSize());
+  ASSERT_TRUE(found);
+  EXPECT_FALSE(found->interesting);
+
+  // A colliding hash with a different size isn't a hit.
+  EXPECT_FALSE((*store)->lookup(first.getContentHash(), first.getSize() + 1));
+  std::filesystem::remove(path);
+}
@@ -0,0 +1,54 @@
+#include "scc/mutator-utils/SeedCorpus.h"
+#include "scc/program/GlobalVar.h"
+#include "scc/program/ProgramSerializer.h"
+#include "gtest/gtest.h"
+
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+namespace {
+std::string getTempDir() {
+  return (std::filesystem::temp_directory_path() /
+          ("scc-seeds-" + std::to_string(getpid())))
+      .string();
+}
+
+Program makeProgram(unsigned globals) {
+  Program p;
+  for (unsigned i = 0; i < globals; ++i)
+    p.add(std::make_unique<GlobalVar>(p.getBuiltin().signed_int,
+                                      p.getIdents().makeNewID("g")));
+  return p;
+}
+} // namespace
+
+TEST(SeedCorpus, DeduplicatesAndKeepsSmallestPrograms) {
+  const std::string dir = getTempDir();
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir);
+  auto save = [&dir](const std::string &name, const Program &p) {
+    ASSERT_FALSE(ProgramSerializer::save(dir + "/" + name, p));
+  };
+  save("a.scc", makeProgram(3));
+  save("b.scc", makeProgram(1));
+  save("c.scc", makeProgram(2));
+  // Prints the same as b.scc.
+  save("d.scc", makeProgram(1));
+  // Only '.scc' files are loaded.
+  save("e.c", makeProgram(0));
+  std::ofstream(dir + "/f.scc") << "corrupt";
+
+  auto seeds = SeedCorpus::load(dir, 100);
+  ASSERT_FALSE(seeds.isErr()) << seeds.getErrorMsg();
+  EXPECT_EQ(seeds->size(), 3U);
+
+  seeds = SeedCorpus::load(dir, 2);
+  ASSERT_FALSE(seeds.isErr());
+  ASSERT_EQ(seeds->size(), 2U);
+  EXPECT_EQ(seeds->at(0).getDeclList().size(), 1U);
+  EXPECT_EQ(seeds->at(1).getDeclList().size(), 2U);
+
+  std::filesystem::remove_all(dir);
+  EXPECT_TRUE(SeedCorpus::load(dir, 100).isErr());
+}
@@ -0,0 +1,20 @@
+#include "scc/mutator-utils/SignatureIndex.h"
+#include "gtest/gtest.h"
+
+TEST(SignatureIndex, ReducesFirstAndSmallerHits) {
+  SignatureIndex index;
+  index.setReductionsPerSignature(1);
+  EXPECT_TRUE(index.addHit("crash-a", 100));
+  EXPECT_FALSE(index.addHit("crash-a", 100));
+  EXPECT_FALSE(index.addHit("crash-a", 150));
+  EXPECT_TRUE(index.addHit("crash-a", 50));
+  EXPECT_TRUE(index.addHit("crash-b", 200));
+  // Hits without a signature can't be deduplicated.
+  EXPECT_TRUE(index.addHit("", 100));
+  EXPECT_TRUE(index.addHit("", 100));
+
+  EXPECT_EQ(index.getDuplicates(), 2U);
+  EXPECT_EQ(index.getNumSignatures(), 2U);
+  EXPECT_EQ(index.getBuckets().at("crash-a").hits, 4U);
+  EXPECT_EQ(index.getBuckets().at("crash-a").smallestNodes, 50U);
+}
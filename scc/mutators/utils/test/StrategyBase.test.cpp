@@ -0,0 +1,66 @@
+#include "scc/mutator-utils/StrategyBase.h"
+#include "gtest/gtest.h"
+
+namespace {
+enum class TestFrag { A, B, C, Count };
+
+struct TestStrategy : StrategyBase<TestStrategy, TestFrag> {
+  TestStrategy() { values.resize(static_cast<size_t>(TestFrag::Count)); }
+};
+} // namespace
+
+TEST(StrategyBase, SerializeRoundTrip) {
+  TestStrategy s;
+  s.setName("some strategy");
+  s.set(TestFrag::A, 0.25f);
+  s.set(TestFrag::C, 1.0f);
+  s.scale = 4;
+  s.generation = 7;
+
+  TestStrategy parsed;
+  EXPECT_FALSE(parsed.deserialize(s.serialize()));
+  EXPECT_EQ(parsed.getName(), "some strategy");
+  EXPECT_EQ(parsed.get(TestFrag::A), 0.25f);
+  EXPECT_EQ(parsed.get(TestFrag::B), 0.0f);
+  EXPECT_EQ(parsed.get(TestFrag::C), 1.0f);
+  EXPECT_EQ(parsed.scale, 4U);
+  EXPECT_EQ(parsed.generation, 7U);
+}
+
+TEST(StrategyBase, DeserializeRejectsMalformed) {
+  TestStrategy s;
+  EXPECT_TRUE(s.deserialize("name\t1\t1\t0.5"));
+  EXPECT_TRUE(s.deserialize("name\t1\t1\t0.5\tx\t0.5"));
+}
+
+TEST(StrategyBase, CrossoverOnlyUsesParentValues) {
+  TestStrategy a;
+  TestStrategy b;
+  for (TestFrag f : {TestFrag::A, TestFrag::B, TestFrag::C}) {
+    a.set(f, 0.0f);
+    b.set(f, 1.0f);
+  }
+  Rng rng(RngSource(1));
+  a.crossover(b, rng);
+  for (TestFrag f : {TestFrag::A, TestFrag::B, TestFrag::C})
+    EXPECT_TRUE(a.get(f) == 0.0f || a.get(f) == 1.0f);
+}
+
+TEST(StrategyBase, ReinforceStaysInBounds) {
+  TestStrategy s;
+  s.set(TestFrag::A, 0.5f);
+  s.set(TestFrag::B, 0.5f);
+  // C is disabled and should never be enabled by learning.
+  const std::vector<TestFrag> taken = {TestFrag::A, TestFrag::A, TestFrag::C};
+
+  for (unsigned i = 0; i < 1000; ++i)
+    s.reinforce(taken, true, 0.1f);
+  EXPECT_EQ(s.get(TestFrag::A), TestStrategy::maxLearnedChance);
+  EXPECT_EQ(s.get(TestFrag::B), 0.5f);
+  EXPECT_EQ(s.get(TestFrag::C), 0.0f);
+
+  for (unsigned i = 0; i < 100000; ++i)
+    s.reinforce(taken, false, 0.1f);
+  EXPECT_EQ(s.get(TestFrag::A), TestStrategy::minLearnedChance);
+  EXPECT_EQ(s.get(TestFrag::C), 0.0f);
+}
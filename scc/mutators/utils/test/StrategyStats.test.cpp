@@ -0,0 +1,25 @@
+#include "scc/mutator-utils/StrategyStats.h"
+#include "gtest/gtest.h"
+
+TEST(StrategyStats, CheapStrategyGetsMoreWeight) {
+  StrategyStats cheap;
+  StrategyStats expensive;
+  for (unsigned i = 0; i < 100; ++i) {
+    cheap.didRun(i % 10 == 0 ? 10 : 0);
+    cheap.oracleMicros += 10000;
+    expensive.didRun(i % 10 == 0 ? 10 : 0);
+    expensive.oracleMicros += 50000;
+  }
+  EXPECT_EQ(cheap.scoreGained, expensive.scoreGained);
+  EXPECT_GT(cheap.getPickWeight(), 4 * expensive.getPickWeight());
+}
+
+TEST(StrategyStats, Rejections) {
+  StrategyStats s;
+  s.didRun(0);
+  s.didReject();
+  s.hitCache();
+  EXPECT_EQ(s.runs, 4U);
+  EXPECT_EQ(s.getRejectionRate(), 50U);
+  EXPECT_EQ(s.getPickWeight(), 1U);
+}
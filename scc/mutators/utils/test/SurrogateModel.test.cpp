@@ -0,0 +1,33 @@
+#include "scc/mutator-utils/SurrogateModel.h"
+#include "scc/mutator-utils/GeneratorUtils.h"
+#include "gtest/gtest.h"
+
+TEST(SurrogateModel, ExtractsStatementHistogram) {
+  Program p;
+  GeneratorUtils::addMain(p);
+  const SurrogateModel::Features empty = SurrogateModel::extract(p);
+  p.add(std::make_unique<Function>(p.getBuiltin().signed_int,
+                                   p.getIdents().makeNewID("f"),
+                                   std::vector<Variable>()));
+  const SurrogateModel::Features more = SurrogateModel::extract(p);
+  ASSERT_EQ(empty.size(), more.size());
+  EXPECT_NE(empty, more);
+}
+
+TEST(SurrogateModel, SkipsCandidatesLearnedToBeUseless) {
+  SurrogateModel model;
+  model.setWarmup(100);
+  model.setSkipFraction(0.5);
+  model.setExplorationRate(0);
+  Rng rng(RngSource(1));
+  const SurrogateModel::Features useful = {1, 0};
+  const SurrogateModel::Features useless = {0, 1};
+  for (unsigned i = 0; i < 100; ++i) {
+    model.train(useful, model.predict(useful, rng), true);
+    model.train(useless, model.predict(useless, rng), false);
+  }
+  EXPECT_FALSE(model.predict(useful, rng).skip);
+  EXPECT_TRUE(model.predict(useless, rng).skip);
+  EXPECT_GT(model.getSkipped(), 0U);
+  EXPECT_EQ(model.getPrecision(), 100U);
+}
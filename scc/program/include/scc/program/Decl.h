@@ -8,6 +8,7 @@
 
 #include <memory>
 
+class BinaryWriter;
 class Program;
 
 /// Extra data associated with declarations.
@@ -16,6 +17,10 @@ struct DeclExtraData {
   virtual std::unique_ptr<DeclExtraData> clone() const = 0;
   virtual void dump(const Program &p) const = 0;
   virtual std::string getSummary(const Program &p) const = 0;
+  /// @see ExtraData::getSerializationTag
+  virtual std::string getSerializationTag() const { return ""; }
+  /// @see ExtraData::serialize
+  virtual void serialize(BinaryWriter &w) const {}
 };
 
 /// Represents a declaration the target program. Can be a function, global
@@ -35,6 +35,7 @@ public:
   }
 
   void setExternalHeader(std::string h) { externalHeader = h; }
+  const std::string &getExternalHeader() const { return externalHeader; }
 
   bool isExternal() const { return !externalHeader.empty(); }
 
@@ -17,6 +17,7 @@ public:
   }
 
   void setInit(Statement s) { initializer = s; }
+  const Statement &getInit() const { return initializer; }
 
   bool is_static = true;
 
@@ -13,6 +13,8 @@
 
 /// Stores all the identifiers in a program.
 struct IdentTable {
+  friend struct ProgramSerializer;
+
   /// This is a unique internal ID for an unqualified identifier (e.g. 'x').
   ///
   /// Note that there is no 1-1 relationship between identifiers and NameIDs.
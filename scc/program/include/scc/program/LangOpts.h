@@ -8,6 +8,8 @@
 
 /// Describes a programming language (e.g., C++ or C89).
 class LangOpts {
+  friend struct ProgramSerializer;
+
 public:
   /// The language standard used.
   enum class Standard {
@@ -43,6 +45,10 @@ public:
 
   bool hasUInt128() const { return HasUInt128; }
 
+  bool hasAsm() const { return Asm; }
+
+  bool hasExceptions() const { return Exceptions; }
+
   OptError loadFromFile(std::string path);
 };
 
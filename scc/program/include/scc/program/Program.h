@@ -22,6 +22,8 @@ class Record;
 ///
 /// Note that this is *not* representing a single translation unit.
 class Program {
+  friend struct ProgramSerializer;
+
   /// List of known identiifers in this program.
   IdentTable idents;
   /// List of types in this program.
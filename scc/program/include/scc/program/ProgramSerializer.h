@@ -0,0 +1,73 @@
+#pragma once
+
+#include "scc/program/Program.h"
+#include "scc/utils/BinaryStream.h"
+#include "scc/utils/Error.h"
+#include "scc/utils/Maybe.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+class Record;
+
+/// Converts programs to a versioned binary format and back.
+///
+/// The format stores the identifier and type tables as they are (including
+/// removed entries), so all NameIDs and TypeRefs stay valid after reading the
+/// program back. All integers are varints and all strings are stored once in
+/// a string table at the start. Statements follow in preorder and only store
+/// the fields they use.
+///
+/// Extra data of statements and declarations is only stored if it has a
+/// serialization tag and a reader for that tag is registered. Extra data with
+/// an unknown tag is dropped when the program is read.
+struct ProgramSerializer {
+  /// Increase when the format changes. Programs with a different version
+  /// can't be read.
+  static constexpr uint64_t version = 2;
+
+  static std::string serialize(const Program &p);
+  static Maybe<Program> deserialize(std::string_view data);
+
+  /// Writes the program as part of a larger stream.
+  static void write(BinaryWriter &w, const Program &p);
+  /// Reads a program written by `write`.
+  static Maybe<Program> read(BinaryReader &r);
+
+  /// Writes the program to a file.
+  static OptError save(const std::string &path, const Program &p);
+  /// Reads a program file written by `save`. The file is mapped into memory
+  /// and read in place.
+  static Maybe<Program> load(const std::string &path);
+
+  typedef std::function<std::unique_ptr<ExtraData>(BinaryReader &)>
+      ExtraDataReader;
+  typedef std::function<std::unique_ptr<DeclExtraData>(BinaryReader &)>
+      DeclExtraDataReader;
+
+  /// Registers the reader for statement extra data with the given tag.
+  /// Not thread-safe, so readers should be registered on startup.
+  static void registerExtraData(const std::string &tag, ExtraDataReader f);
+  /// Registers the reader for declaration extra data with the given tag.
+  static void registerDeclExtraData(const std::string &tag,
+                                    DeclExtraDataReader f);
+
+private:
+  struct WriteState;
+  struct ReadState;
+
+  static void writeIdents(WriteState &s, const IdentTable &idents);
+  static void readIdents(ReadState &s, IdentTable &idents);
+  static void writeType(WriteState &s, const Type &t);
+  static Type readType(ReadState &s);
+  static void writeDecl(WriteState &s, const Decl &d);
+  static std::unique_ptr<Decl> readDecl(ReadState &s);
+  static void writeRecord(WriteState &s, const Record &r);
+  static std::unique_ptr<Decl> readRecord(ReadState &s, NameID name);
+  static void writeStatement(WriteState &s, const Statement &stmt);
+  static Statement readStatement(ReadState &s);
+  static void writeLangOpts(WriteState &s, const LangOpts &opts);
+  static LangOpts readLangOpts(ReadState &s);
+};
@@ -8,6 +8,12 @@
 
 /// Represents a struct/class/union declaration in our program.
 class Record : public NamedDecl {
+  friend struct ProgramSerializer;
+
+  /// Creates a record with an existing type.
+  Record(IdentTable::NameID name, TypeRef type)
+      : NamedDecl(Decl::Kind::Record, name), type(type) {}
+
 public:
   Record(Program &p, IdentTable::NameID name, bool packed = false);
 
@@ -11,6 +11,7 @@
 #include <set>
 #include <vector>
 
+class BinaryWriter;
 class Program;
 class Statement;
 
@@ -24,10 +25,18 @@ struct ExtraData {
   virtual void printSuffix(const Statement &s, PrintState &state) const {}
   virtual bool usesType(TypeRef t) const { return false; }
   virtual bool usesID(NameID id) const { return false; }
+  /// The tag the reader of this data was registered with (see
+  /// `ProgramSerializer::registerExtraData`). Data without a tag is dropped
+  /// when the program is serialized.
+  virtual std::string getSerializationTag() const { return ""; }
+  /// Writes the data for the reader registered under the tag.
+  virtual void serialize(BinaryWriter &w) const {}
 };
 
 /// Describes a statement/expression in a C/C++ AST.
 class Statement {
+  friend struct ProgramSerializer;
+
   static void expectExpr(const Statement &s) {
     assert(s.isExpr());
     assert(s.getKind() != Kind::Compound);
@@ -540,6 +549,13 @@ public:
 
   bool usesType(TypeRef t) const;
 
+  /// Replaces every identifier and type referenced by this statement and its
+  /// children with the result of the given functions.
+  ///
+  /// Used to move statements between programs. Extra data is not remapped.
+  void remap(const std::function<NameID(NameID)> &mapID,
+             const std::function<TypeRef(TypeRef)> &mapType);
+
   bool usesID(NameID wantedId) const {
     if (id == wantedId)
       return true;
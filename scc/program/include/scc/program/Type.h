@@ -14,6 +14,7 @@ class Program;
 /// Represents any type in a program.
 class Type {
   friend class TypeTable;
+  friend struct ProgramSerializer;
 
 public:
   /// Different ways how a type can be derived.
@@ -159,6 +160,10 @@ public:
 
   TypeRef getRef() const { return ref; }
 
+  /// Returns the name of a basic type or the alias of an array/function
+  /// pointer type.
+  NameID getNameID() const { return id; }
+
   void print(PrintState &state) const;
 
   void printPreamble(PrintState &state) const;
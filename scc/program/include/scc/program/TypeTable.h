@@ -8,6 +8,8 @@
 
 /// Contains all types in a program.
 class TypeTable {
+  friend struct ProgramSerializer;
+
   /// List of types. Indices are values of TypeRef
   /// values.
   std::vector<Type> types;
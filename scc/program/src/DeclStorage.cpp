@@ -8,7 +8,7 @@ DeclStorage &DeclStorage::operator=(const DeclStorage &o) {
   namedDecls.clear();
   decls.clear();
   for (const auto &d : o.decls)
-    store(static_cast<NamedDecl *>(d->clone()));
+    store(static_cast<NamedDecl *>(d->clone()), decls.size());
   return *this;
 }
 
@@ -0,0 +1,551 @@
+#include "scc/program/ProgramSerializer.h"
+
+#include "scc/program/GlobalVar.h"
+#include "scc/program/RecordDecl.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <map>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+
+namespace {
+typedef std::map<std::string, ProgramSerializer::ExtraDataReader, std::less<>>
+    ExtraDataReaderMap;
+typedef std::map<std::string, ProgramSerializer::DeclExtraDataReader,
+                 std::less<>>
+    DeclExtraDataReaderMap;
+
+ExtraDataReaderMap &getExtraDataReaders() {
+  static ExtraDataReaderMap readers;
+  return readers;
+}
+
+DeclExtraDataReaderMap &getDeclExtraDataReaders() {
+  static DeclExtraDataReaderMap readers;
+  return readers;
+}
+
+/// Marks which optional fields of a statement are stored. Most statements
+/// only use a few of them, so this saves a lot of space.
+enum StatementFields : uint64_t {
+  HasID = 1 << 0,
+  HasConstant = 1 << 1,
+  HasType = 1 << 2,
+  HasOtherType = 1 << 3,
+  HasExtraData = 1 << 4,
+  HasChildren = 1 << 5,
+  AllFields = (1 << 6) - 1,
+};
+
+/// The number of types and identifiers a new program starts with. The
+/// builtin types are referenced by index, so programs are only compatible
+/// if these are the same.
+std::pair<size_t, size_t> getBuiltinLayout() {
+  static const std::pair<size_t, size_t> layout = []() {
+    Program p;
+    return std::make_pair<size_t, size_t>(
+        p.getIdents().getLastID().getInternalVal(),
+        std::distance(p.getTypes().begin(), p.getTypes().end()));
+  }();
+  return layout;
+}
+
+const std::string_view fileMagic = "SCCP";
+} // namespace
+
+/// Collects the string table while the rest of the program is written.
+struct ProgramSerializer::WriteState {
+  BinaryWriter w;
+  std::unordered_map<std::string, uint64_t> stringIDs;
+  std::vector<const std::string *> strings;
+
+  void writeString(const std::string &str) {
+    auto inserted = stringIDs.emplace(str, strings.size());
+    if (inserted.second)
+      strings.push_back(&inserted.first->first);
+    w.writeUInt(inserted.first->second);
+  }
+
+  /// InvalidName is stored as 0 so it takes one byte.
+  void writeNameID(NameID id) {
+    w.writeUInt(id == InvalidName ? 0 : id.getInternalVal() + 1);
+  }
+
+  void writeTypeRef(TypeRef t) { w.writeUInt(t.getInternalVal()); }
+
+  void writeOpt(const std::string &v) { writeString(v); }
+  void writeOpt(bool v) { w.writeBool(v); }
+
+  /// Writes the tag and the data as a nested string, so data with an unknown
+  /// tag can be skipped.
+  template <typename DataT> void writeExtraData(const DataT *data) {
+    const std::string tag = data ? data->getSerializationTag() : "";
+    writeString(tag);
+    if (tag.empty())
+      return;
+    BinaryWriter nested;
+    data->serialize(nested);
+    w.writeString(nested.getData());
+  }
+};
+
+/// Validates references while reading a program. Strings are views into the
+/// input and are only copied when they are stored in the program.
+struct ProgramSerializer::ReadState {
+  explicit ReadState(BinaryReader &r) : r(r) {}
+
+  BinaryReader &r;
+  std::vector<std::string_view> strings;
+  size_t numIdents = 0;
+  size_t numTypes = 0;
+
+  std::string_view readStringView() {
+    const uint64_t v = r.readUInt();
+    if (v >= strings.size()) {
+      r.fail("Invalid string " + std::to_string(v));
+      return {};
+    }
+    return strings[v];
+  }
+
+  std::string readString() { return std::string(readStringView()); }
+
+  NameID readNameID() {
+    const uint64_t v = r.readUInt();
+    if (v == 0)
+      return InvalidName;
+    if (v > numIdents)
+      r.fail("Invalid identifier " + std::to_string(v - 1));
+    return NameID::fromInternalValue(v - 1);
+  }
+
+  TypeRef readTypeRef() {
+    const uint64_t v = r.readUInt();
+    if (v >= numTypes)
+      r.fail("Invalid type " + std::to_string(v));
+    return TypeRef::fromInternalValue(v);
+  }
+
+  template <typename DataT, typename MapT>
+  std::unique_ptr<DataT> readExtraData(const MapT &m) {
+    const std::string_view tag = readStringView();
+    if (tag.empty())
+      return nullptr;
+    const std::string_view payload = r.readStringView();
+    auto reader = m.find(tag);
+    if (reader == m.end())
+      return nullptr;
+    BinaryReader nested(payload);
+    std::unique_ptr<DataT> res = reader->second(nested);
+    if (nested.hasFailed())
+      r.fail("Malformed extra data '" + std::string(tag) +
+             "': " + nested.getError());
+    return res;
+  }
+
+  void readOpt(std::string &v) { v = readString(); }
+  void readOpt(bool &v) { v = r.readBool(); }
+};
+
+std::string ProgramSerializer::serialize(const Program &p) {
+  BinaryWriter w;
+  write(w, p);
+  return w.getData();
+}
+
+Maybe<Program> ProgramSerializer::deserialize(std::string_view data) {
+  BinaryReader r(data);
+  Maybe<Program> res = read(r);
+  if (!res.isErr() && !r.atEnd())
+    return Err("Trailing data after serialized program");
+  return res;
+}
+
+OptError ProgramSerializer::save(const std::string &path, const Program &p) {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out << fileMagic << serialize(p);
+  if (!out)
+    return Err("Failed to write program to " + path);
+  return {};
+}
+
+Maybe<Program> ProgramSerializer::load(const std::string &path) {
+  const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return Err("Failed to open " + path + ": " + std::strerror(errno));
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    close(fd);
+    return Err(path + " is not a program file");
+  }
+  const size_t size = static_cast<size_t>(st.st_size);
+  void *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping stays valid after closing the file.
+  close(fd);
+  if (mapping == MAP_FAILED)
+    return Err("Failed to map " + path + ": " + std::strerror(errno));
+
+  const std::string_view data(static_cast<const char *>(mapping), size);
+  if (data.substr(0, fileMagic.size()) != fileMagic) {
+    munmap(mapping, size);
+    return Err(path + " is not a program file");
+  }
+  Maybe<Program> res = deserialize(data.substr(fileMagic.size()));
+  munmap(mapping, size);
+  return res;
+}
+
+void ProgramSerializer::write(BinaryWriter &w, const Program &p) {
+  WriteState s;
+  writeLangOpts(s, p.opts);
+  writeIdents(s, p.idents);
+
+  s.w.writeUInt(p.types.types.size());
+  for (const Type &t : p.types.types)
+    writeType(s, t);
+
+  const std::vector<Decl *> decls = p.getDeclList();
+  s.w.writeUInt(decls.size());
+  for (const Decl *d : decls)
+    writeDecl(s, *d);
+
+  w.writeUInt(version);
+  const auto layout = getBuiltinLayout();
+  w.writeUInt(layout.first);
+  w.writeUInt(layout.second);
+  w.writeUInt(s.strings.size());
+  for (const std::string *str : s.strings)
+    w.writeString(*str);
+  w.writeBytes(s.w.getData());
+}
+
+Maybe<Program> ProgramSerializer::read(BinaryReader &r) {
+  const uint64_t readVersion = r.readUInt();
+  if (!r.hasFailed() && readVersion != version)
+    return Err("Unsupported program format version " +
+               std::to_string(readVersion));
+  const auto layout = getBuiltinLayout();
+  const uint64_t builtinIdents = r.readUInt();
+  const uint64_t builtinTypes = r.readUInt();
+  if (!r.hasFailed() &&
+      (builtinIdents != layout.first || builtinTypes != layout.second))
+    return Err("Program was written with different builtin types");
+
+  ReadState s(r);
+  const size_t numStrings = r.readSize();
+  s.strings.reserve(numStrings);
+  for (size_t i = 0; i < numStrings && !r.hasFailed(); ++i)
+    s.strings.push_back(r.readStringView());
+
+  Program p;
+  p.opts = readLangOpts(s);
+
+  readIdents(s, p.idents);
+  s.numIdents = p.idents.names.size();
+
+  const size_t numTypes = r.readSize();
+  s.numTypes = numTypes;
+  std::vector<Type> types;
+  types.reserve(numTypes);
+  for (size_t i = 0; i < numTypes && !r.hasFailed(); ++i)
+    types.push_back(readType(s));
+
+  // Builtin types are never removed, so a table without them is corrupt.
+  if (!r.hasFailed() && numTypes < layout.second)
+    r.fail("Type table is missing builtin types");
+  p.types.types = std::move(types);
+
+  const size_t numDecls = r.readSize();
+  for (size_t i = 0; i < numDecls && !r.hasFailed(); ++i) {
+    std::unique_ptr<Decl> d = readDecl(s);
+    if (!d)
+      break;
+    // Only named declarations exist so far.
+    p.global.store(static_cast<NamedDecl *>(d.release()), p.global.size());
+  }
+
+  if (r.hasFailed())
+    return Err("Malformed program: " + r.getError());
+  return p;
+}
+
+void ProgramSerializer::registerExtraData(const std::string &tag,
+                                          ExtraDataReader f) {
+  getExtraDataReaders()[tag] = f;
+}
+
+void ProgramSerializer::registerDeclExtraData(const std::string &tag,
+                                              DeclExtraDataReader f) {
+  getDeclExtraDataReaders()[tag] = f;
+}
+
+void ProgramSerializer::writeIdents(WriteState &s, const IdentTable &idents) {
+  s.w.writeUInt(idents.names.size());
+  for (const IdentTable::NameInfo &info : idents.names) {
+    s.writeString(info.name);
+    s.w.writeUInt((info.fixed ? 1 : 0) | (info.valid ? 2 : 0));
+  }
+}
+
+void ProgramSerializer::readIdents(ReadState &s, IdentTable &idents) {
+  const size_t size = s.r.readSize();
+  idents.names.clear();
+  idents.names.reserve(size);
+  for (size_t i = 0; i < size && !s.r.hasFailed(); ++i) {
+    IdentTable::NameInfo info;
+    info.name = s.readString();
+    const uint64_t flags = s.r.readUInt();
+    if (flags > 3)
+      s.r.fail("Invalid identifier flags " + std::to_string(flags));
+    info.fixed = flags & 1;
+    info.valid = flags & 2;
+    idents.names.push_back(info);
+  }
+}
+
+void ProgramSerializer::writeType(WriteState &s, const Type &t) {
+  s.w.writeUInt(static_cast<uint64_t>(t.kind));
+  s.writeNameID(t.id);
+  s.w.writeUInt(t.size);
+  s.w.writeBool(t.isSignedType);
+  s.w.writeUInt(t.arraySize);
+  s.writeTypeRef(t.ref);
+  s.writeTypeRef(t.base);
+  s.w.writeUInt(t.args.size());
+  for (TypeRef arg : t.args)
+    s.writeTypeRef(arg);
+}
+
+Type ProgramSerializer::readType(ReadState &s) {
+  Type t;
+  t.kind = s.r.readEnum(Type::Kind::Volatile);
+  t.id = s.readNameID();
+  t.size = s.r.readUInt();
+  t.isSignedType = s.r.readBool();
+  t.arraySize = s.r.readUInt();
+  t.ref = s.readTypeRef();
+  t.base = s.readTypeRef();
+  const size_t numArgs = s.r.readSize();
+  for (size_t i = 0; i < numArgs && !s.r.hasFailed(); ++i)
+    t.args.push_back(s.readTypeRef());
+  return t;
+}
+
+void ProgramSerializer::writeDecl(WriteState &s, const Decl &d) {
+  BinaryWriter &w = s.w;
+  w.writeUInt(static_cast<uint64_t>(d.getKind()));
+  s.writeNameID(static_cast<const NamedDecl &>(d).getNameID());
+  s.writeExtraData(d.getExtraData());
+
+  switch (d.getKind()) {
+  case Decl::Kind::Function: {
+    const Function &f = static_cast<const Function &>(d);
+    s.writeTypeRef(f.getReturnType());
+    w.writeUInt(f.getArgs().size());
+    for (const Variable &arg : f.getArgs()) {
+      s.writeTypeRef(arg.getType());
+      s.writeNameID(arg.getName());
+    }
+    w.writeBool(f.isVariadic());
+    s.writeString(f.callingConv);
+    w.writeUInt(static_cast<uint64_t>(f.weight));
+    w.writeBool(f.isStatic);
+    w.writeBool(f.isNoExcept);
+    s.writeString(f.getExternalHeader());
+    const std::vector<std::string> attrs = f.getAllAttrs();
+    w.writeUInt(attrs.size());
+    for (const std::string &attr : attrs)
+      s.writeString(attr);
+    writeStatement(s, f.getBody());
+    return;
+  }
+  case Decl::Kind::GlobalVar: {
+    const GlobalVar &g = static_cast<const GlobalVar &>(d);
+    s.writeTypeRef(g.getAsVar().getType());
+    w.writeBool(g.is_static);
+    writeStatement(s, g.getInit());
+    return;
+  }
+  case Decl::Kind::Record:
+    writeRecord(s, static_cast<const Record &>(d));
+    return;
+  }
+  SCCError("Unknown decl kind");
+}
+
+std::unique_ptr<Decl> ProgramSerializer::readDecl(ReadState &s) {
+  BinaryReader &r = s.r;
+  const Decl::Kind kind = r.readEnum(Decl::Kind::Record);
+  const NameID name = s.readNameID();
+  std::unique_ptr<DeclExtraData> extraData =
+      s.readExtraData<DeclExtraData>(getDeclExtraDataReaders());
+  if (r.hasFailed())
+    return nullptr;
+
+  std::unique_ptr<Decl> res;
+  switch (kind) {
+  case Decl::Kind::Function: {
+    const TypeRef returnType = s.readTypeRef();
+    std::vector<Variable> args;
+    const size_t numArgs = r.readSize();
+    for (size_t i = 0; i < numArgs && !r.hasFailed(); ++i) {
+      const TypeRef t = s.readTypeRef();
+      args.emplace_back(t, s.readNameID());
+    }
+    const bool variadic = r.readBool();
+    auto f = std::make_unique<Function>(
+        returnType, name, args,
+        variadic ? Function::Variadic::Yes : Function::Variadic::No);
+    f->callingConv = s.readString();
+    f->weight = r.readEnum(Function::Weight::None);
+    f->isStatic = r.readBool();
+    f->isNoExcept = r.readBool();
+    f->setExternalHeader(s.readString());
+    const size_t numAttrs = r.readSize();
+    for (size_t i = 0; i < numAttrs && !r.hasFailed(); ++i)
+      f->addAttr(s.readString());
+    f->setBody(readStatement(s));
+    res = std::move(f);
+    break;
+  }
+  case Decl::Kind::GlobalVar: {
+    const TypeRef t = s.readTypeRef();
+    if (t == Void()) {
+      r.fail("Global variable with void type");
+      return nullptr;
+    }
+    auto g = std::make_unique<GlobalVar>(t, name);
+    g->is_static = r.readBool();
+    g->setInit(readStatement(s));
+    res = std::move(g);
+    break;
+  }
+  case Decl::Kind::Record:
+    res = readRecord(s, name);
+    break;
+  }
+  if (r.hasFailed())
+    return nullptr;
+  res->setExtraData(std::move(extraData));
+  return res;
+}
+
+void ProgramSerializer::writeRecord(WriteState &s, const Record &r) {
+  BinaryWriter &w = s.w;
+  s.writeTypeRef(r.getType());
+  w.writeUInt(r.alignment);
+  w.writeBool(r.isAUnion);
+  w.writeBool(r.packed);
+  w.writeUInt(r.fields.size());
+  for (const Record::Field &f : r.fields) {
+    s.writeNameID(f.getName());
+    s.writeTypeRef(f.getType());
+    w.writeBool(f.getBitfieldSize().has_value());
+    w.writeUInt(f.getBitfieldSize().value_or(0));
+    w.writeUInt(f.getMinAlignment());
+  }
+}
+
+std::unique_ptr<Decl> ProgramSerializer::readRecord(ReadState &s,
+                                                    NameID name) {
+  BinaryReader &r = s.r;
+  std::unique_ptr<Record> res(new Record(name, s.readTypeRef()));
+  res->alignment = r.readUInt();
+  res->isAUnion = r.readBool();
+  res->packed = r.readBool();
+  const size_t numFields = r.readSize();
+  for (size_t i = 0; i < numFields && !r.hasFailed(); ++i) {
+    const NameID fieldName = s.readNameID();
+    const TypeRef t = s.readTypeRef();
+    const bool isBitfield = r.readBool();
+    const unsigned bitSize = r.readUInt();
+    std::optional<unsigned> bitfieldSize;
+    if (isBitfield)
+      bitfieldSize = bitSize;
+    Record::Field f(fieldName, t, bitfieldSize);
+    f.setAlignment(r.readUInt());
+    res->fields.push_back(f);
+  }
+  return res;
+}
+
+void ProgramSerializer::writeStatement(WriteState &s, const Statement &stmt) {
+  const ExtraData *extraData = stmt.getExtraData();
+  uint64_t fields = 0;
+  if (stmt.id != InvalidName)
+    fields |= HasID;
+  if (!stmt.constantValue.empty())
+    fields |= HasConstant;
+  if (stmt.type != Void())
+    fields |= HasType;
+  if (stmt.otherType != Void())
+    fields |= HasOtherType;
+  if (extraData && !extraData->getSerializationTag().empty())
+    fields |= HasExtraData;
+  if (!stmt.children.empty())
+    fields |= HasChildren;
+
+  s.w.writeUInt(static_cast<uint64_t>(stmt.kind));
+  s.w.writeUInt(fields);
+  if (fields & HasID)
+    s.writeNameID(stmt.id);
+  if (fields & HasConstant)
+    s.writeString(stmt.constantValue);
+  if (fields & HasType)
+    s.writeTypeRef(stmt.type);
+  if (fields & HasOtherType)
+    s.writeTypeRef(stmt.otherType);
+  if (fields & HasExtraData)
+    s.writeExtraData(extraData);
+  if (fields & HasChildren) {
+    s.w.writeUInt(stmt.children.size());
+    for (const Statement &child : stmt.children)
+      writeStatement(s, child);
+  }
+}
+
+Statement ProgramSerializer::readStatement(ReadState &s) {
+  Statement res;
+  res.kind = s.r.readEnum(Statement::Kind::Group);
+  const uint64_t fields = s.r.readUInt();
+  if (fields & ~uint64_t(AllFields))
+    s.r.fail("Invalid statement fields " + std::to_string(fields));
+  if (fields & HasID)
+    res.id = s.readNameID();
+  if (fields & HasConstant)
+    res.constantValue = s.readString();
+  if (fields & HasType)
+    res.type = s.readTypeRef();
+  if (fields & HasOtherType)
+    res.otherType = s.readTypeRef();
+  if (fields & HasExtraData)
+    res.setExtraData(s.readExtraData<ExtraData>(getExtraDataReaders()));
+  if (fields & HasChildren) {
+    const size_t numChildren = s.r.readSize();
+    if (numChildren > Statement::maxChildren)
+      s.r.fail("Statement has too many children");
+    res.children.reserve(numChildren);
+    for (size_t i = 0; i < numChildren && !s.r.hasFailed(); ++i)
+      res.children.push_back(readStatement(s));
+  }
+  return res;
+}
+
+void ProgramSerializer::writeLangOpts(WriteState &s, const LangOpts &opts) {
+#define LANG_OPT(type, id, str, def) s.writeOpt(opts.id);
+#include "scc/program/LangOpts.def"
+  s.w.writeUInt(static_cast<uint64_t>(opts.standardEnum));
+}
+
+LangOpts ProgramSerializer::readLangOpts(ReadState &s) {
+  LangOpts opts;
+#define LANG_OPT(type, id, str, def) s.readOpt(opts.id);
+#include "scc/program/LangOpts.def"
+  opts.standardEnum = s.r.readEnum(LangOpts::Standard::Cxx17);
+  return opts;
+}
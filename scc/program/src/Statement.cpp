@@ -444,6 +444,18 @@ bool Statement::usesType(TypeRef t) const {
   return false;
 }
 
+void Statement::remap(const std::function<NameID(NameID)> &mapID,
+                      const std::function<TypeRef(TypeRef)> &mapType) {
+  if (id != InvalidName)
+    id = mapID(id);
+  if (type != Void())
+    type = mapType(type);
+  if (otherType != Void())
+    otherType = mapType(otherType);
+  for (Statement &c : children)
+    c.remap(mapID, mapType);
+}
+
 void Statement::verifySelf(const Program &p) const {
   if (type != Void())
     SCCAssert(p.getTypes().isValid(type), "Must have a valid non-void type");
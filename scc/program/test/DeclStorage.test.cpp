@@ -0,0 +1,17 @@
+#include "scc/program/DeclStorage.h"
+#include "scc/program/GlobalVar.h"
+#include "scc/program/Program.h"
+#include "gtest/gtest.h"
+
+TEST(DeclStorage, CopyKeepsOrder) {
+  Program p;
+  const TypeRef t = p.getBuiltin().signed_int;
+  p.add(std::make_unique<GlobalVar>(t, p.getIdents().makeNewID("a")));
+  p.add(std::make_unique<GlobalVar>(t, p.getIdents().makeNewID("b")));
+
+  const Program copy = p;
+  ASSERT_EQ(copy.getDeclList().size(), 2U);
+  for (size_t i = 0; i < 2; ++i)
+    EXPECT_EQ(static_cast<NamedDecl *>(copy.getDeclList().at(i))->getNameID(),
+              static_cast<NamedDecl *>(p.getDeclList().at(i))->getNameID());
+}
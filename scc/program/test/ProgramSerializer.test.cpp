@@ -0,0 +1,151 @@
+#include "scc/program/ProgramSerializer.h"
+#include "scc/program/GlobalVar.h"
+#include "scc/program/RecordDecl.h"
+#include "gtest/gtest.h"
+
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+namespace {
+std::string print(const Program &p) {
+  OutString out(/*fancy=*/false);
+  p.print(out).assumeSuccess("Failed to print program");
+  return out.getStr();
+}
+
+struct Marker : ExtraData {
+  int value = 0;
+  explicit Marker(int v) : value(v) {}
+  std::unique_ptr<ExtraData> clone() const override {
+    return std::make_unique<Marker>(*this);
+  }
+  void dump(const Program &p) const override {}
+  std::string getSummary(const Program &p) const override { return ""; }
+  std::string getSerializationTag() const override { return "marker"; }
+  void serialize(BinaryWriter &w) const override { w.writeInt(value); }
+};
+
+Program makeProgram() {
+  Program p;
+  const TypeRef t = p.getBuiltin().signed_int;
+  // Leave a hole in the identifier table.
+  p.getIdents().remove(p.getIdents().makeNewID("unused"));
+  p.getIdents().makeNewID("kept");
+
+  const NameID field = p.getIdents().makeNewID("f");
+  Record &record = p.add(Record::Struct(
+      p, p.getIdents().makeNewID("S"), {Record::Field(field, t, 3)}));
+  auto global =
+      std::make_unique<GlobalVar>(record.getType(), p.getIdents().makeNewID());
+  const Variable var = global->getAsVar();
+  p.add(std::move(global));
+
+  auto f = std::make_unique<Function>(t, p.getIdents().createID("main", true),
+                                      std::vector<Variable>());
+  Statement ret = Statement::Return(
+      Statement::Dot(t, Statement::GlobalVarRef(var), field));
+  ret.setExtraData(std::make_unique<Marker>(-7));
+  f->setBody(Statement::CompoundStmt({ret}));
+  f->isStatic = true;
+  p.add(std::move(f));
+  return p;
+}
+} // namespace
+
+TEST(ProgramSerializer, RoundTrip) {
+  ProgramSerializer::registerExtraData("marker", [](BinaryReader &r) {
+    return std::make_unique<Marker>(r.readInt());
+  });
+
+  const Program p = makeProgram();
+  Maybe<Program> read =
+      ProgramSerializer::deserialize(ProgramSerializer::serialize(p));
+  ASSERT_FALSE(read.isErr()) << read.getErrorMsg();
+  EXPECT_EQ(print(*read), print(p));
+  EXPECT_EQ(read->countNodes(), p.countNodes());
+  EXPECT_EQ(read->getIdents().getLastID(), p.getIdents().getLastID());
+  // New identifiers are appended after the restored ones.
+  EXPECT_EQ(read->getIdents().makeNewID(), p.getIdents().getLastID());
+
+  const Function &main = static_cast<const Function &>(
+      read->lookup(read->getIdents().getOrCreateID("main")));
+  EXPECT_TRUE(main.isStatic);
+  const Statement &ret = main.getBody().getChildren().front();
+  ASSERT_NE(ret.getExtraData(), nullptr);
+  EXPECT_EQ(static_cast<const Marker *>(ret.getExtraData())->value, -7);
+}
+
+TEST(ProgramSerializer, RejectsCorruptData) {
+  const std::string data = ProgramSerializer::serialize(makeProgram());
+  EXPECT_TRUE(ProgramSerializer::deserialize(data.substr(0, data.size() / 2))
+                  .isErr());
+  EXPECT_TRUE(ProgramSerializer::deserialize(data + "x").isErr());
+
+  std::string otherVersion = data;
+  otherVersion[0] = ProgramSerializer::version + 1;
+  Maybe<Program> read = ProgramSerializer::deserialize(otherVersion);
+  ASSERT_TRUE(read.isErr());
+  EXPECT_EQ(read.getErrorMsg(), "Unsupported program format version 3");
+}
+
+TEST(ProgramSerializer, SharesStrings) {
+  Program p;
+  auto f = std::make_unique<Function>(p.getBuiltin().signed_int,
+                                      p.getIdents().createID("main", true),
+                                      std::vector<Variable>());
+  std::vector<Statement> stmts;
+  const std::string longConstant(1000, '1');
+  for (unsigned i = 0; i < 10; ++i)
+    stmts.push_back(Statement::StmtExpr(
+        Statement::Constant(longConstant, p.getBuiltin().signed_int)));
+  f->setBody(Statement::CompoundStmt(stmts));
+  p.add(std::move(f));
+  // The constant is only stored once.
+  EXPECT_LT(ProgramSerializer::serialize(p).size(), 2 * longConstant.size());
+}
+
+TEST(ProgramSerializer, SaveAndLoadFile) {
+  const std::string path = (std::filesystem::temp_directory_path() /
+                            ("scc-program-" + std::to_string(getpid())))
+                               .string();
+  const Program p = makeProgram();
+  ASSERT_FALSE(ProgramSerializer::save(path, p));
+  Maybe<Program> read = ProgramSerializer::load(path);
+  ASSERT_FALSE(read.isErr()) << read.getErrorMsg();
+  EXPECT_EQ(print(*read), print(p));
+
+  std::ofstream(path, std::ios::trunc) << "int main() {}";
+  read = ProgramSerializer::load(path);
+  ASSERT_TRUE(read.isErr());
+  EXPECT_EQ(read.getErrorMsg(), path + " is not a program file");
+  std::filesystem::remove(path);
+  EXPECT_TRUE(ProgramSerializer::load(path).isErr());
+}
+
+TEST(ProgramSerializer, LargeProgramRoundTrip) {
+  Program p;
+  const TypeRef t = p.getBuiltin().signed_int;
+  std::vector<Statement> stmts;
+  for (unsigned i = 0; i < 2000; ++i) {
+    auto global = std::make_unique<GlobalVar>(t, p.getIdents().makeNewID());
+    const Variable var = global->getAsVar();
+    p.add(std::move(global));
+    stmts.push_back(Statement::StmtExpr(Statement::BinaryOp(
+        p, Statement::Kind::Add, Statement::GlobalVarRef(var),
+        Statement::Constant(std::to_string(i), t))));
+  }
+  auto f = std::make_unique<Function>(t, p.getIdents().createID("main", true),
+                                      std::vector<Variable>());
+  f->setBody(Statement::CompoundStmt(stmts));
+  p.add(std::move(f));
+
+  const std::string data = ProgramSerializer::serialize(p);
+  Maybe<Program> read = ProgramSerializer::deserialize(data);
+  ASSERT_FALSE(read.isErr()) << read.getErrorMsg();
+  EXPECT_EQ(print(*read), print(p));
+  EXPECT_EQ(read->countNodes(), p.countNodes());
+  EXPECT_EQ(read->getDeclList().size(), p.getDeclList().size());
+  // Serializing the read program gives the same bytes again.
+  EXPECT_EQ(ProgramSerializer::serialize(*read), data);
+}
@@ -0,0 +1,73 @@
+#ifndef BINARYSTREAM_H
+#define BINARYSTREAM_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/// Writes values in a compact binary format that `BinaryReader` can read.
+///
+/// Unsigned integers are stored as LEB128 so small values take one byte.
+class BinaryWriter {
+  std::string data;
+
+public:
+  void writeUInt(uint64_t v);
+  /// Zigzag encoded so small negative values are also short.
+  void writeInt(int64_t v);
+  void writeBool(bool b) { data.push_back(b ? 1 : 0); }
+  void writeDouble(double d);
+  void writeString(std::string_view s);
+  /// Appends data without a size prefix, e.g. the contents of another writer.
+  void writeBytes(std::string_view bytes) { data.append(bytes); }
+
+  const std::string &getData() const { return data; }
+};
+
+/// Reads values written by `BinaryWriter`.
+///
+/// Errors are sticky: after the first malformed value, all reads return
+/// default values and `hasFailed` returns true. Callers can therefore read a
+/// whole structure and check for errors once.
+class BinaryReader {
+  std::string_view data;
+  size_t pos = 0;
+  std::string error;
+
+public:
+  explicit BinaryReader(std::string_view data) : data(data) {}
+
+  uint64_t readUInt();
+  int64_t readInt();
+  bool readBool();
+  double readDouble();
+  std::string readString();
+  /// Like `readString`, but returns a view into the data instead of a copy.
+  std::string_view readStringView();
+
+  /// Reads the number of elements of a following list. Fails if there can't
+  /// be that many elements left, so corrupt sizes don't cause huge
+  /// allocations.
+  size_t readSize();
+
+  /// Reads an enum value and fails if it is larger than `max`.
+  template <typename EnumT> EnumT readEnum(EnumT max) {
+    const uint64_t v = readUInt();
+    if (v > static_cast<uint64_t>(max)) {
+      fail("Invalid enum value " + std::to_string(v));
+      return EnumT();
+    }
+    return static_cast<EnumT>(v);
+  }
+
+  /// Marks the input as malformed. Only the first error is kept.
+  void fail(std::string msg);
+
+  bool hasFailed() const { return !error.empty(); }
+  const std::string &getError() const { return error; }
+
+  bool atEnd() const { return pos == data.size(); }
+  size_t getRemaining() const { return data.size() - pos; }
+};
+
+#endif // BINARYSTREAM_H
@@ -5,6 +5,7 @@
 #include "scc/utils/SCCAssert.h"
 
 #include <string>
+#include <utility>
 #include <variant>
 
 /// Either a given value or an error.
@@ -17,7 +18,7 @@ template <typename T> class Maybe {
 
 public:
   Maybe() { storage = Error::withMsg("Unknown default error"); }
-  Maybe(T v) : storage(v) {}
+  Maybe(T v) : storage(std::move(v)) {}
 
   Maybe(Error w) : storage(w) {}
 
@@ -2,6 +2,7 @@
 
 #include "scc/utils/SCCAssert.h"
 #include <cassert>
+#include <cstdint>
 #include <string>
 #include <string_view>
 
@@ -104,7 +105,7 @@ public:
     supportsColor = fancy;
   }
   virtual ~OutString();
-  virtual void writeImpl(std::string_view s) { storage.append(std::string(s)); }
+  virtual void writeImpl(std::string_view s) { storage.append(s); }
 
   const std::string &getStr() const { return storage; }
 };
@@ -119,17 +120,50 @@ struct StdErrOutStream : public OutStream {
   virtual void writeImpl(std::string_view s);
 };
 
+/// An OutStream that only counts the number of written characters.
+class CountingStream : public OutStream {
+public:
+  virtual ~CountingStream();
+  virtual void writeImpl(std::string_view s) { size += s.size(); }
+
+  /// Returns the number of characters written so far.
+  size_t getSize() const { return size; }
+
+private:
+  size_t size = 0;
+};
+
 /// An OutStream that just hashes it's output.
+///
+/// Also counts the written characters so that hash and size can be computed
+/// by printing only once.
 class HashStream : public OutStream {
 public:
   virtual ~HashStream();
   virtual void writeImpl(std::string_view s) {
     hash ^= std::hash<std::string_view>()(s);
+    size += s.size();
+    // FNV-1a.
+    for (char c : s) {
+      contentHash ^= static_cast<unsigned char>(c);
+      contentHash *= 1099511628211ULL;
+    }
   }
 
   typedef size_t Hash;
   size_t getHash() const { return hash; }
 
+  /// Returns a hash of the written characters that depends on their order.
+  /// `getHash` ignores the order of the written fragments and repeated
+  /// fragments cancel out, so it's only good enough for caches that can
+  /// tolerate collisions.
+  uint64_t getContentHash() const { return contentHash; }
+
+  /// Returns the number of characters written so far.
+  size_t getSize() const { return size; }
+
 private:
   size_t hash = 0;
+  uint64_t contentHash = 14695981039346656037ULL;
+  size_t size = 0;
 };
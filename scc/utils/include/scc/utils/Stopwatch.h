@@ -0,0 +1,30 @@
+#ifndef STOPWATCH_H
+#define STOPWATCH_H
+
+#include <chrono>
+#include <cstdint>
+
+/// Measures elapsed wall-clock time.
+class Stopwatch {
+  typedef std::chrono::steady_clock Clock;
+  Clock::time_point start = Clock::now();
+
+public:
+  /// Returns the microseconds since construction or the last reset.
+  uint64_t getMicros() const {
+    using namespace std::chrono;
+    return duration_cast<microseconds>(Clock::now() - start).count();
+  }
+
+  /// Returns the microseconds since the last reset and resets the stopwatch.
+  uint64_t lap() {
+    const uint64_t res = getMicros();
+    reset();
+    return res;
+  }
+
+  /// Starts measuring from the current point in time.
+  void reset() { start = Clock::now(); }
+};
+
+#endif // STOPWATCH_H
@@ -0,0 +1,53 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// A fixed set of worker threads that run submitted tasks.
+///
+/// The threads are kept alive until the pool is destroyed, so submitting
+/// work doesn't pay for starting new threads.
+class ThreadPool {
+  std::vector<std::thread> workers;
+  /// Tasks that haven't been started yet.
+  std::deque<std::function<void()>> tasks;
+  std::mutex mutex;
+  std::condition_variable taskAvailable;
+  bool stopping = false;
+
+  void workerLoop();
+
+public:
+  /// Creates a pool with the given number of threads (at least one).
+  explicit ThreadPool(size_t threads);
+  /// Finishes all queued tasks and joins the worker threads.
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  /// Queues the given function and returns a future for its result.
+  template <typename F> auto submit(F f) -> std::future<decltype(f())> {
+    typedef decltype(f()) Result;
+    auto task = std::make_shared<std::packaged_task<Result()>>(std::move(f));
+    std::future<Result> res = task->get_future();
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      tasks.emplace_back([task]() { (*task)(); });
+    }
+    taskAvailable.notify_one();
+    return res;
+  }
+
+  /// Returns the number of worker threads.
+  size_t size() const { return workers.size(); }
+};
+
+#endif // THREADPOOL_H
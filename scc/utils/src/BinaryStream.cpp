@@ -0,0 +1,101 @@
+#include "scc/utils/BinaryStream.h"
+
+#include <cstring>
+
+void BinaryWriter::writeUInt(uint64_t v) {
+  while (v >= 0x80) {
+    data.push_back(static_cast<char>((v & 0x7F) | 0x80));
+    v >>= 7;
+  }
+  data.push_back(static_cast<char>(v));
+}
+
+void BinaryWriter::writeInt(int64_t v) {
+  const uint64_t u = static_cast<uint64_t>(v);
+  writeUInt((u << 1) ^ (v < 0 ? ~uint64_t(0) : 0));
+}
+
+void BinaryWriter::writeDouble(double d) {
+  uint64_t bits;
+  static_assert(sizeof(bits) == sizeof(d));
+  std::memcpy(&bits, &d, sizeof(d));
+  for (unsigned i = 0; i < sizeof(bits); ++i)
+    data.push_back(static_cast<char>(bits >> (i * 8)));
+}
+
+void BinaryWriter::writeString(std::string_view s) {
+  writeUInt(s.size());
+  data.append(s);
+}
+
+uint64_t BinaryReader::readUInt() {
+  uint64_t res = 0;
+  for (unsigned shift = 0; shift < 64; shift += 7) {
+    if (hasFailed() || atEnd()) {
+      fail("Unexpected end of data");
+      return 0;
+    }
+    const uint8_t byte = static_cast<uint8_t>(data[pos++]);
+    res |= uint64_t(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0)
+      return res;
+  }
+  fail("Integer is too long");
+  return 0;
+}
+
+int64_t BinaryReader::readInt() {
+  const uint64_t u = readUInt();
+  return static_cast<int64_t>((u >> 1) ^ (~(u & 1) + 1));
+}
+
+bool BinaryReader::readBool() {
+  const uint64_t v = readUInt();
+  if (v > 1)
+    fail("Invalid boolean value " + std::to_string(v));
+  return v == 1;
+}
+
+double BinaryReader::readDouble() {
+  uint64_t bits = 0;
+  if (hasFailed() || getRemaining() < sizeof(bits)) {
+    fail("Unexpected end of data");
+    return 0;
+  }
+  for (unsigned i = 0; i < sizeof(bits); ++i)
+    bits |= uint64_t(static_cast<uint8_t>(data[pos++])) << (i * 8);
+  double res;
+  std::memcpy(&res, &bits, sizeof(res));
+  return res;
+}
+
+std::string BinaryReader::readString() {
+  return std::string(readStringView());
+}
+
+std::string_view BinaryReader::readStringView() {
+  const uint64_t size = readUInt();
+  if (hasFailed() || size > getRemaining()) {
+    fail("String is longer than the remaining data");
+    return {};
+  }
+  std::string_view res = data.substr(pos, size);
+  pos += size;
+  return res;
+}
+
+size_t BinaryReader::readSize() {
+  const uint64_t size = readUInt();
+  // Every element takes at least one byte.
+  if (size > getRemaining()) {
+    fail("List is longer than the remaining data");
+    return 0;
+  }
+  return size;
+}
+
+void BinaryReader::fail(std::string msg) {
+  if (error.empty())
+    error = msg;
+  pos = data.size();
+}
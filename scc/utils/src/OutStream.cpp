@@ -67,6 +67,9 @@ void OutStream::setColor(Color c) {
 // pin vtable.
 OutString::~OutString() {}
 
+// pin vtable.
+CountingStream::~CountingStream() {}
+
 // pin vtable.
 HashStream::~HashStream() {}
 
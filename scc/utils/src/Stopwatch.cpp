@@ -0,0 +1 @@
+#include "scc/utils/Stopwatch.h"
@@ -0,0 +1,33 @@
+#include "scc/utils/ThreadPool.h"
+
+ThreadPool::ThreadPool(size_t threads) {
+  if (threads == 0)
+    threads = 1;
+  for (size_t i = 0; i < threads; ++i)
+    workers.emplace_back([this]() { workerLoop(); });
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  taskAvailable.notify_all();
+  for (std::thread &t : workers)
+    t.join();
+}
+
+void ThreadPool::workerLoop() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      taskAvailable.wait(lock, [this]() { return stopping || !tasks.empty(); });
+      if (tasks.empty())
+        return;
+      task = std::move(tasks.front());
+      tasks.pop_front();
+    }
+    task();
+  }
+}
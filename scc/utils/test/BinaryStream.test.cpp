@@ -0,0 +1,73 @@
+#include "scc/utils/BinaryStream.h"
+#include "gtest/gtest.h"
+
+#include <limits>
+
+TEST(BinaryStream, RoundTrip) {
+  BinaryWriter w;
+  w.writeUInt(0);
+  w.writeUInt(std::numeric_limits<uint64_t>::max());
+  w.writeInt(-3);
+  w.writeInt(std::numeric_limits<int64_t>::min());
+  w.writeBool(true);
+  w.writeDouble(0.25);
+  w.writeString(std::string("a\0b", 3));
+
+  BinaryReader r(w.getData());
+  EXPECT_EQ(r.readUInt(), 0U);
+  EXPECT_EQ(r.readUInt(), std::numeric_limits<uint64_t>::max());
+  EXPECT_EQ(r.readInt(), -3);
+  EXPECT_EQ(r.readInt(), std::numeric_limits<int64_t>::min());
+  EXPECT_TRUE(r.readBool());
+  EXPECT_EQ(r.readDouble(), 0.25);
+  EXPECT_EQ(r.readString(), std::string("a\0b", 3));
+  EXPECT_TRUE(r.atEnd());
+  EXPECT_FALSE(r.hasFailed());
+}
+
+TEST(BinaryStream, SmallValuesTakeOneByte) {
+  BinaryWriter w;
+  w.writeUInt(127);
+  w.writeInt(-64);
+  EXPECT_EQ(w.getData().size(), 2U);
+}
+
+TEST(BinaryStream, ErrorsAreSticky) {
+  BinaryWriter w;
+  w.writeUInt(1000);
+  w.writeUInt(7);
+
+  BinaryReader r(w.getData());
+  // The size is larger than the remaining bytes.
+  EXPECT_EQ(r.readSize(), 0U);
+  EXPECT_TRUE(r.hasFailed());
+  EXPECT_EQ(r.readUInt(), 0U);
+  EXPECT_EQ(r.getError(), "List is longer than the remaining data");
+}
+
+TEST(BinaryStream, RejectsInvalidEnums) {
+  enum class E { A, B };
+  BinaryWriter w;
+  w.writeUInt(1);
+  w.writeUInt(2);
+  BinaryReader r(w.getData());
+  EXPECT_EQ(r.readEnum(E::B), E::B);
+  EXPECT_FALSE(r.hasFailed());
+  r.readEnum(E::B);
+  EXPECT_TRUE(r.hasFailed());
+}
+
+TEST(BinaryStream, StringViewsPointIntoData) {
+  BinaryWriter inner;
+  inner.writeString("abc");
+  BinaryWriter w;
+  w.writeBytes(inner.getData());
+  w.writeUInt(5);
+
+  BinaryReader r(w.getData());
+  const std::string_view s = r.readStringView();
+  EXPECT_EQ(s, "abc");
+  EXPECT_EQ(s.data(), w.getData().data() + 1);
+  EXPECT_EQ(r.readUInt(), 5U);
+  EXPECT_TRUE(r.atEnd());
+}
@@ -7,3 +7,18 @@ TEST(OutString, Basic) {
   s << "bar";
   ASSERT_EQ(s.getStr(), "foobar");
 }
+
+TEST(CountingStream, CountsLikeOutString) {
+  OutString str;
+  CountingStream count;
+  HashStream hash;
+  for (OutStream *s : std::vector<OutStream *>{&str, &count, &hash}) {
+    *s << "int";
+    s->increaseIndent();
+    s->printIndent();
+    *s << "x;";
+    s->decreaseIndent();
+  }
+  EXPECT_EQ(count.getSize(), str.getStr().size());
+  EXPECT_EQ(hash.getSize(), str.getStr().size());
+}
@@ -0,0 +1,11 @@
+#include "scc/utils/Stopwatch.h"
+#include "gtest/gtest.h"
+
+#include <thread>
+
+TEST(Stopwatch, Lap) {
+  Stopwatch s;
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  EXPECT_GE(s.lap(), 2000U);
+  EXPECT_LT(s.getMicros(), 2000U);
+}
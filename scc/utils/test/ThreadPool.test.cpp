@@ -0,0 +1,21 @@
+#include "scc/utils/ThreadPool.h"
+#include "gtest/gtest.h"
+
+#include <atomic>
+
+TEST(ThreadPool, RunsAllTasks) {
+  std::atomic<unsigned> counter = 0;
+  std::vector<std::future<unsigned>> results;
+  {
+    ThreadPool pool(4);
+    EXPECT_EQ(pool.size(), 4U);
+    for (unsigned i = 0; i < 100; ++i)
+      results.push_back(pool.submit([i, &counter]() {
+        ++counter;
+        return i * 2;
+      }));
+    for (unsigned i = 0; i < 100; ++i)
+      EXPECT_EQ(results.at(i).get(), i * 2);
+  }
+  EXPECT_EQ(counter, 100U);
+}